@@ -0,0 +1,46 @@
+#version 450
+
+// no vertex input, everything is fetched from the record of this instance
+struct SpriteRecord {
+  vec2 center;
+  vec2 halfSize;
+  vec4 uvRect; // min in xy, max in zw
+  uint color;  // unorm8 rgba
+  uint kind;
+  uint reserved0;
+  uint reserved1;
+};
+
+layout(std430, binding = 2) readonly buffer SpriteRecords {
+  SpriteRecord records[];
+};
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 TexCoord;
+layout(location = 2) flat out uint kind;
+
+layout(push_constant, std430) uniform PushConstantObject {
+  mat2 transform;
+  vec2 offset;
+  float opacity;
+  uint textureIndex;
+  vec4 tint;
+} pc;
+
+// two triangles per sprite, same corners as the rectangle
+const vec2 corners[6] = vec2[] (
+  vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+  vec2(1.0, 1.0), vec2(-1.0, 1.0), vec2(-1.0, -1.0)
+);
+
+void main() {
+  // gl_InstanceIndex includes firstInstance, which selects the first record of the draw
+  SpriteRecord record = records[gl_InstanceIndex];
+  vec2 corner = corners[gl_VertexIndex];
+  vec2 position = record.center + corner * record.halfSize;
+
+  gl_Position = vec4(pc.transform * position + pc.offset, 0.0, 1.0);
+  fragColor = unpackUnorm4x8(record.color);
+  TexCoord = mix(record.uvRect.xy, record.uvRect.zw, corner * 0.5 + 0.5);
+  kind = record.kind;
+}
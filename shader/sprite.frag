@@ -0,0 +1,24 @@
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 TexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform UniformObject {
+  float opacity;
+} ubo;
+
+layout(binding = 1) uniform sampler2D tex;
+
+layout(push_constant, std430) uniform PushConstantObject {
+  mat2 transform;
+  vec2 offset;
+  float opacity;
+  uint textureIndex;
+  vec4 tint;
+} pc;
+
+void main() {
+  outColor = fragColor * vec4(1.0, 1.0, 1.0, ubo.opacity * pc.opacity) * pc.tint * texture(tex, TexCoord);
+}
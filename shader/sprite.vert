@@ -0,0 +1,24 @@
+#version 450
+
+// packed attributes, the vertex fetch expands them to floats
+layout(location = 0) in vec2 position; // snorm16, relative to the batch bounds
+layout(location = 1) in vec2 uv;       // unorm16
+layout(location = 2) in vec4 color;    // unorm8
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 TexCoord;
+
+// the batch bounds are folded into transform and offset, see QuantizationFrame::Apply
+layout(push_constant, std430) uniform PushConstantObject {
+  mat2 transform;
+  vec2 offset;
+  float opacity;
+  uint textureIndex;
+  vec4 tint;
+} pc;
+
+void main() {
+  gl_Position = vec4(pc.transform * position + pc.offset, 0.0, 1.0);
+  fragColor = color;
+  TexCoord = uv;
+}
@@ -5,6 +5,14 @@ layout(location = 0) in vec2 position;
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 TexCoord;
 
+layout(push_constant, std430) uniform PushConstantObject {
+  mat2 transform;
+  vec2 offset;
+  float opacity;
+  uint textureIndex;
+  vec4 tint;
+} pc;
+
 vec3 colors[4] = vec3[] (
   vec3(1.0, 0.0, 0.0),
   vec3(0.0, 1.0, 0.0),
@@ -20,7 +28,7 @@ vec2 TexCoords[4] = vec2[] (
 );
 
 void main() {
-  gl_Position = vec4(position, 0.0, 1.0);
+  gl_Position = vec4(pc.transform * position + pc.offset, 0.0, 1.0);
   fragColor = colors[gl_VertexIndex];
   TexCoord = TexCoords[gl_VertexIndex];
 }
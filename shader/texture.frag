@@ -11,6 +11,14 @@ layout(binding = 0) uniform UniformObject {
 
 layout(binding = 1) uniform sampler2D tex;
 
+layout(push_constant, std430) uniform PushConstantObject {
+  mat2 transform;
+  vec2 offset;
+  float opacity;
+  uint textureIndex;
+  vec4 tint;
+} pc;
+
 void main() {
-  outColor = vec4(fragColor, ubo.opacity) * texture(tex, TexCoord);
+  outColor = vec4(fragColor, ubo.opacity * pc.opacity) * pc.tint * texture(tex, TexCoord);
 }
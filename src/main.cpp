@@ -9,6 +9,7 @@
 
 #include "toy2d/toy2d.hpp"
 
+#include <fstream>
 #include <iostream>
 #include <vector>
 #include <array>
@@ -35,9 +36,13 @@ static std::array<uint32_t, 6> rect_indices = {
 static toy2d::UniformObject ubo {
     .opacity = 1.0f
 };
+static toy2d::PushConstantObject pushConstant;
+static bool showOverlay = false;
+static int spriteMode = 0; // 0: off, 1: packed vertices, 2: vertex pulling, 3: GPU pointers
 toy2d::Renderer* pRenderer;
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (action != GLFW_REPEAT) pRenderer->GetFrameTimer().MarkInput();
     if (key == GLFW_KEY_A && action == GLFW_PRESS) {
         ubo.opacity = 0.5f;
         pRenderer->SetUniformObject(ubo);
@@ -46,6 +51,28 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         ubo.opacity = 1.0f;
         pRenderer->SetUniformObject(ubo);
     }
+    // per-draw tint through push constants, no buffer writes
+    if (key == GLFW_KEY_T && action == GLFW_PRESS) {
+        pushConstant.tint = {1.0f, 0.4f, 0.4f, 1.0f};
+    }
+    if (key == GLFW_KEY_T && action == GLFW_RELEASE) {
+        pushConstant.tint = {1.0f, 1.0f, 1.0f, 1.0f};
+    }
+    // additive colorful overlay, a second program drawn in the same frame
+    if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+        showOverlay = !showOverlay;
+    }
+    // a grid of sprites, drawn from packed 12-byte vertices or pulled from a storage buffer
+    if (key == GLFW_KEY_S && action == GLFW_PRESS) {
+        spriteMode = (spriteMode + 1) % 4;
+    }
+    // device memory statistics, summary to the log and everything to a json file
+    if (key == GLFW_KEY_M && action == GLFW_PRESS) {
+        auto stats = toy2d::GetMemoryManager().getStats();
+        stats.Report(std::clog);
+        std::ofstream file("memory-stats.json");
+        stats.WriteJson(file);
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -110,12 +137,42 @@ int main(int argc, char* argv[]) {
     renderer.SetUniformObject(ubo);
 //    renderer.SetTexture("resources/texture.png");
 
+    toy2d::SpriteBatch sprites;
+    std::array<toy2d::SpriteBatch, 2> spriteLayers; // textured below solid
+    for (int y = 0; y < 18; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            toy2d::Sprite sprite {
+                .center = vec2(-1.0f + (x + 0.5f) / 16.0f, -1.0f + (y + 0.5f) / 9.0f),
+                .size = vec2(0.05f, 0.09f),
+                .color = toy2d::vec4(x / 31.0f, y / 17.0f, 1.0f - x / 31.0f, 0.8f),
+                .kind = (x + y) % 2 ? toy2d::SpriteKind::Solid : toy2d::SpriteKind::Textured,
+            };
+            sprites.Add(sprite);
+            spriteLayers[static_cast<size_t>(sprite.kind)].Add(sprite);
+        }
+    }
+    renderer.SetSprites(sprites);
+    renderer.SetSpriteRecords(sprites);
+    renderer.SetSpriteScene(spriteLayers);
+
+    auto& registry = toy2d::GetPipelineRegistry();
+    auto overlay = registry.Request({ .program = registry.FindProgram("colorful"), .blend = toy2d::BlendMode::Additive });
+
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
         // renderer.DrawTriangle();
-        renderer.DrawRectangle();
+        renderer.Render([&](vk::CommandBuffer& cmdBuf) {
+            renderer.DrawRectangle(cmdBuf, pushConstant, renderer.GetDefaultPipeline());
+            // compiled in the background the first time it is shown, skipped until then
+            if (spriteMode == 1) renderer.DrawSprites(cmdBuf, pushConstant);
+            if (spriteMode == 2) renderer.DrawSpriteRecords(cmdBuf, pushConstant);
+            if (spriteMode == 3) renderer.DrawSpriteScene(cmdBuf, pushConstant);
+            if (showOverlay) renderer.DrawRectangle(cmdBuf, toy2d::PushConstantObject(), overlay, toy2d::PipelineFallback::Skip);
+        });
     }
 
+    renderer.GetFrameTimer().Report(std::clog);
+
     toy2d::Quit();
 
     glfwDestroyWindow(window);
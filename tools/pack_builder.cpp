@@ -0,0 +1,213 @@
+/**
+  * @file   pack_builder.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  builds a .pack archive read by toy2d::AssetPack
+  */
+
+#include "toy2d/pack_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(TOY2D_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace toy2d;
+
+namespace {
+
+struct Input {
+    std::string name; // relative to the root, '/' separated
+    fs::path path;
+};
+
+struct Packed {
+    pack::Entry entry;
+    std::string name;
+    std::vector<char> stored;
+};
+
+void PrintUsage() {
+    std::cerr << "usage: toy2d_pack [--zstd] [--align N] [--root DIR] <output.pack> <file or directory>...\n"
+                 "  names are paths relative to --root (the current directory by default)\n";
+}
+
+std::vector<char> ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    std::vector<char> content(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    return content;
+}
+
+void CollectInputs(const fs::path& root, const fs::path& path, std::vector<Input>& inputs) {
+    auto add = [&](const fs::path& file) {
+        inputs.push_back({ fs::relative(file, root).generic_string(), file });
+    };
+    if (fs::is_directory(path)) {
+        for (const auto& item : fs::recursive_directory_iterator(path)) {
+            if (item.is_regular_file()) add(item.path());
+        }
+    } else if (fs::is_regular_file(path)) {
+        add(path);
+    } else {
+        throw std::runtime_error("No such file or directory: " + path.string());
+    }
+}
+
+Packed PackFile(const Input& input, bool compress) {
+    Packed packed;
+    packed.name = input.name;
+    packed.stored = ReadFile(input.path);
+    packed.entry = {};
+    packed.entry.hash = pack::Hash(input.name);
+    packed.entry.size = packed.stored.size();
+    packed.entry.compression = pack::Compression::None;
+
+#if defined(TOY2D_HAS_ZSTD)
+    if (compress && !packed.stored.empty()) {
+        std::vector<char> compressed(ZSTD_compressBound(packed.stored.size()));
+        auto size = ZSTD_compress(compressed.data(), compressed.size(), packed.stored.data(), packed.stored.size(), 19);
+        // already compressed formats (png) rarely shrink, those stay stored so they can be used in place
+        if (!ZSTD_isError(size) && size < packed.stored.size() - packed.stored.size() / 8) {
+            compressed.resize(size);
+            packed.stored = std::move(compressed);
+            packed.entry.compression = pack::Compression::Zstd;
+        }
+    }
+#else
+    if (compress) {
+        throw std::runtime_error("toy2d_pack was built without zstd, --zstd is unavailable.");
+    }
+#endif
+    packed.entry.storedSize = packed.stored.size();
+    return packed;
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void Pad(std::ofstream& out, uint64_t& offset, uint64_t alignment) {
+    auto aligned = AlignUp(offset, alignment);
+    std::string zeros(aligned - offset, '\0');
+    out.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    offset = aligned;
+}
+
+void WritePack(const fs::path& output, std::vector<Packed>& files, uint32_t alignment) {
+    std::ranges::sort(files, [](const Packed& a, const Packed& b) {
+        return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.name < b.name;
+    });
+    for (size_t i = 1; i < files.size(); ++i) {
+        if (files[i].name == files[i - 1].name) {
+            throw std::runtime_error("Asset is listed twice: " + files[i].name);
+        }
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to create file: " + output.string());
+    }
+
+    pack::Header header {};
+    std::memcpy(header.magic, pack::magic, sizeof(pack::magic));
+    header.version = pack::version;
+    header.entryCount = static_cast<uint32_t>(files.size());
+    header.alignment = alignment;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    for (auto& file : files) {
+        Pad(out, offset, alignment);
+        file.entry.offset = offset;
+        out.write(file.stored.data(), static_cast<std::streamsize>(file.stored.size()));
+        offset += file.stored.size();
+    }
+
+    std::string names;
+    Pad(out, offset, alignof(pack::Entry));
+    header.indexOffset = offset;
+    for (auto& file : files) {
+        file.entry.nameOffset = static_cast<uint32_t>(names.size());
+        file.entry.nameLength = static_cast<uint32_t>(file.name.size());
+        names += file.name;
+        out.write(reinterpret_cast<const char*>(&file.entry), sizeof(pack::Entry));
+        offset += sizeof(pack::Entry);
+    }
+
+    header.namesOffset = offset;
+    header.namesSize = names.size();
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    // the offsets are only known now
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        throw std::runtime_error("Failed to write file: " + output.string());
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool compress = false;
+    uint32_t alignment = pack::defaultAlignment;
+    fs::path root = fs::current_path();
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--zstd") {
+            compress = true;
+        } else if (arg == "--align" && i + 1 < argc) {
+            alignment = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--root" && i + 1 < argc) {
+            root = argv[++i];
+        } else if (arg.starts_with("--")) {
+            PrintUsage();
+            return 1;
+        } else {
+            positional.push_back(std::move(arg));
+        }
+    }
+    if (positional.size() < 2 || alignment < 4 || (alignment & (alignment - 1)) != 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    try {
+        std::vector<Input> inputs;
+        for (size_t i = 1; i < positional.size(); ++i) {
+            CollectInputs(root, root / positional[i], inputs);
+        }
+
+        std::vector<Packed> files;
+        uint64_t rawSize = 0, storedSize = 0;
+        for (const auto& input : inputs) {
+            files.push_back(PackFile(input, compress));
+            rawSize += files.back().entry.size;
+            storedSize += files.back().entry.storedSize;
+        }
+        WritePack(positional[0], files, alignment);
+
+        std::cout << "Packed " << files.size() << " assets into " << positional[0]
+                  << " (" << rawSize << " -> " << storedSize << " bytes)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+  * @file   asset_pack.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "asset_pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+#if defined(TOY2D_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace toy2d {
+
+Asset::Asset(MappedFile file) : _file(std::move(file)) {
+    _data = _file->data();
+}
+
+Asset::Asset(std::span<const std::byte> borrowed) : _data(borrowed) {}
+
+Asset::Asset(std::vector<std::byte> decompressed) : _decompressed(std::move(decompressed)) {
+    _data = _decompressed;
+}
+
+Asset::Asset(Asset&& other) noexcept
+    : _file(std::move(other._file)), _decompressed(std::move(other._decompressed)), _data(std::exchange(other._data, {})) {
+    // moving a vector or a mapping keeps the address of the bytes, so _data stays valid
+}
+
+Asset& Asset::operator=(Asset&& other) noexcept {
+    _file = std::move(other._file);
+    _decompressed = std::move(other._decompressed);
+    _data = std::exchange(other._data, {});
+    return *this;
+}
+
+std::span<const std::byte> Asset::data() const {
+    return _data;
+}
+
+size_t Asset::size() const {
+    return _data.size();
+}
+
+AssetPack::AssetPack(std::string path) : _file(std::move(path), MappedFile::Hint::Random) {
+    auto bytes = _file.data();
+    if (bytes.size() < sizeof(pack::Header)) {
+        throw std::runtime_error("Asset pack is truncated: " + _file.path());
+    }
+
+    pack::Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, pack::magic, sizeof(pack::magic)) != 0 || header.version != pack::version) {
+        throw std::runtime_error("Not a supported asset pack: " + _file.path());
+    }
+
+    // the index and names are used in place, so check they lie inside the mapping once here
+    auto indexSize = static_cast<uint64_t>(header.entryCount) * sizeof(pack::Entry);
+    if (header.indexOffset % alignof(pack::Entry) != 0 ||
+        header.indexOffset > bytes.size() || indexSize > bytes.size() - header.indexOffset ||
+        header.namesOffset > bytes.size() || header.namesSize > bytes.size() - header.namesOffset) {
+        throw std::runtime_error("Asset pack index is corrupt: " + _file.path());
+    }
+    _entries = { reinterpret_cast<const pack::Entry*>(bytes.data() + header.indexOffset), header.entryCount };
+    _names = { reinterpret_cast<const char*>(bytes.data() + header.namesOffset), header.namesSize };
+
+    for (const auto& entry : _entries) {
+        if (entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset ||
+            static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > _names.size()) {
+            throw std::runtime_error("Asset pack entry is corrupt: " + _file.path());
+        }
+    }
+}
+
+std::optional<Asset> AssetPack::Find(std::string_view name) const {
+    const auto* entry = findEntry(name);
+    if (!entry) return std::nullopt;
+
+    auto stored = _file.data().subspan(entry->offset, entry->storedSize);
+    switch (entry->compression) {
+    case pack::Compression::None:
+        return Asset(stored);
+    case pack::Compression::Zstd: {
+#if defined(TOY2D_HAS_ZSTD)
+        std::vector<std::byte> decompressed(entry->size);
+        auto result = ZSTD_decompress(decompressed.data(), decompressed.size(), stored.data(), stored.size());
+        if (ZSTD_isError(result) || result != entry->size) {
+            throw std::runtime_error("Failed to decompress asset '" + std::string(name) + "' in " + _file.path());
+        }
+        return Asset(std::move(decompressed));
+#else
+        throw std::runtime_error("Asset '" + std::string(name) + "' is zstd compressed, but toy2d was built without zstd.");
+#endif
+    }
+    }
+    throw std::runtime_error("Unknown compression of asset '" + std::string(name) + "' in " + _file.path());
+}
+
+bool AssetPack::Contains(std::string_view name) const {
+    return findEntry(name) != nullptr;
+}
+
+size_t AssetPack::getEntryCount() const {
+    return _entries.size();
+}
+
+const std::string& AssetPack::getPath() const {
+    return _file.path();
+}
+
+const pack::Entry* AssetPack::findEntry(std::string_view name) const {
+    // entries are sorted by hash, collisions are told apart by the name
+    auto hash = pack::Hash(name);
+    auto range = std::ranges::equal_range(_entries, hash, {}, &pack::Entry::hash);
+    auto it = std::ranges::find_if(range, [&](const pack::Entry& entry) { return entryName(entry) == name; });
+    return it == range.end() ? nullptr : &*it;
+}
+
+std::string_view AssetPack::entryName(const pack::Entry& entry) const {
+    return _names.substr(entry.nameOffset, entry.nameLength);
+}
+
+void AssetLoader::Mount(std::string packPath) {
+    _packs.push_back(std::make_unique<AssetPack>(std::move(packPath)));
+}
+
+Asset AssetLoader::Load(std::string_view name, MappedFile::Hint hint) const {
+#ifndef NDEBUG
+    // development builds prefer loose files, so freshly compiled shaders and edited textures win over a stale pack
+    if (std::filesystem::exists(name)) return Asset(MappedFile(std::string(name), hint));
+#endif
+    for (auto pack = _packs.rbegin(); pack != _packs.rend(); ++pack) {
+        if (auto asset = (*pack)->Find(name)) return std::move(*asset);
+    }
+    return Asset(MappedFile(std::string(name), hint));
+}
+
+}
@@ -0,0 +1,72 @@
+/**
+  * @file   asset_pack.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "mapped_file.hpp"
+#include "pack_format.hpp"
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace toy2d {
+
+// the bytes of one asset: a loose mapped file, a slice of a mapped pack, or a decompressed copy
+class Asset {
+private:
+    std::optional<MappedFile> _file;
+    std::vector<std::byte> _decompressed;
+    std::span<const std::byte> _data;
+
+public:
+    explicit Asset(MappedFile file);
+    explicit Asset(std::span<const std::byte> borrowed); // the pack must outlive the asset
+    explicit Asset(std::vector<std::byte> decompressed);
+    Asset(Asset&& other) noexcept;
+    Asset& operator=(Asset&& other) noexcept;
+
+    std::span<const std::byte> data() const;
+    size_t size() const;
+};
+
+// a mapped .pack archive, see pack_format.hpp
+class AssetPack {
+private:
+    MappedFile _file;
+    std::span<const pack::Entry> _entries;
+    std::string_view _names;
+
+public:
+    explicit AssetPack(std::string path);
+
+    std::optional<Asset> Find(std::string_view name) const;
+    bool Contains(std::string_view name) const;
+    size_t getEntryCount() const;
+    const std::string& getPath() const;
+
+private:
+    const pack::Entry* findEntry(std::string_view name) const;
+    std::string_view entryName(const pack::Entry& entry) const;
+};
+
+// serves assets by name from the mounted packs, falling back to loose files on disk
+// debug builds (no NDEBUG) check loose files first, release builds read the packs first
+class AssetLoader {
+private:
+    std::vector<std::unique_ptr<AssetPack>> _packs; // searched newest first, so later mounts override
+
+public:
+    void Mount(std::string packPath);
+    Asset Load(std::string_view name, MappedFile::Hint hint = MappedFile::Hint::Sequential) const;
+};
+
+}
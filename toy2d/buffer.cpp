@@ -11,18 +11,37 @@
 
 namespace toy2d {
 
+namespace {
+
+MemoryCategory CategoryOf(vk::BufferUsageFlags usage) {
+    using Usage = vk::BufferUsageFlagBits;
+    if (usage & Usage::eVertexBuffer) return MemoryCategory::Vertex;
+    if (usage & Usage::eIndexBuffer) return MemoryCategory::Index;
+    if (usage & Usage::eUniformBuffer) return MemoryCategory::Uniform;
+    if (usage & (Usage::eStorageBuffer | Usage::eShaderDeviceAddress)) return MemoryCategory::Storage;
+    if (usage & Usage::eTransferSrc) return MemoryCategory::Staging; // nothing but a copy source
+    return MemoryCategory::Other;
+}
+
+}
+
 Buffer::Buffer(size_t size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags property)
-    : size(size), memoryInfo{ .usage = usage, .property = property } {
+    : Buffer(size, usage, std::vector { MemoryRequest::FromFlags(property) }) {}
+
+Buffer::Buffer(size_t size, vk::BufferUsageFlags usage, std::vector<MemoryRequest> requests)
+    : size(size), memoryInfo{ .requests = std::move(requests), .usage = usage } {
+    if ((usage & vk::BufferUsageFlagBits::eShaderDeviceAddress) && !Context::GetInstance().features.bufferDeviceAddress) {
+        throw std::runtime_error("Buffer device addresses are not supported by this device.");
+    }
     createBuffer();
-    queryMemoryInfo();
     allocMemory();
     bindMemoryToBuffer();
 }
 
 Buffer::~Buffer() {
-    auto& device = Context::GetInstance().device;
-    device.freeMemory(memory);
-    device.destroyBuffer(buffer);
+    auto& ctx = Context::GetInstance();
+    ctx.memoryManager->Free(memory);
+    ctx.device.destroyBuffer(buffer);
 }
 
 void Buffer::createBuffer() {
@@ -34,41 +53,40 @@ void Buffer::createBuffer() {
     buffer = Context::GetInstance().device.createBuffer(createInfo);
 }
 
-void Buffer::queryMemoryInfo() {
+void Buffer::allocMemory() {
     auto& ctx = Context::GetInstance();
     auto requirements = ctx.device.getBufferMemoryRequirements(buffer);
-    memoryInfo.size = requirements.size;
 
-    memoryInfo.memoryTypeIndex = QueryMemoryTypeIndex(requirements.memoryTypeBits,memoryInfo.property);
+    // addresses can only be taken of buffers bound to memory allocated for it
+    vk::MemoryAllocateFlagsInfo flagsInfo;
+    flagsInfo.setFlags(vk::MemoryAllocateFlagBits::eDeviceAddress);
+    bool deviceAddress = bool(memoryInfo.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress);
 
-    if (!memoryInfo.memoryTypeIndex.has_value()) {
-        throw std::runtime_error("Failed to find suitable memory type for buffer.");
-    }
-}
-
-void Buffer::allocMemory() {
-    vk::MemoryAllocateInfo allocInfo;
-    allocInfo
-    .setAllocationSize(memoryInfo.size)
-    .setMemoryTypeIndex(memoryInfo.memoryTypeIndex.value());
-    memory = Context::GetInstance().device.allocateMemory(allocInfo);
+    memory = ctx.memoryManager->Allocate(requirements, memoryInfo.requests, CategoryOf(memoryInfo.usage), size,
+                                         deviceAddress ? &flagsInfo : nullptr);
+    memoryInfo.property = ctx.memoryManager->getMemoryProperty(memory);
 }
 
 void Buffer::bindMemoryToBuffer() {
-    Context::GetInstance().device.bindBufferMemory(buffer, memory, 0);
-}
+    auto& device = Context::GetInstance().device;
+    device.bindBufferMemory(buffer, memory, 0);
 
-std::optional<size_t> Buffer::QueryMemoryTypeIndex(uint32_t type, vk::MemoryPropertyFlags propertyFlags) {
-    auto& ctx = Context::GetInstance();
-    auto properties = ctx.phyDevice.getMemoryProperties();
+    if (memoryInfo.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress) {
+        vk::BufferDeviceAddressInfo addressInfo;
+        addressInfo.setBuffer(buffer);
+        _deviceAddress = device.getBufferAddress(addressInfo);
+    }
+}
 
-    for (size_t i = 0; i < properties.memoryTypeCount; ++i) {
-        if ((type & (1 << i)) &&
-            (properties.memoryTypes[i].propertyFlags & propertyFlags)) {
-            return i;
-        }
+vk::DeviceAddress Buffer::getDeviceAddress() const {
+    if (_deviceAddress == 0) {
+        throw std::runtime_error("Buffer was not created with eShaderDeviceAddress.");
     }
-    return {};
+    return _deviceAddress;
+}
+
+vk::MemoryPropertyFlags Buffer::getMemoryProperty() const {
+    return memoryInfo.property;
 }
 
 }
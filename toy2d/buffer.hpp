@@ -9,7 +9,9 @@
 
 #include "vulkan/vulkan.hpp"
 
-#include <optional>
+#include "memory_manager.hpp"
+
+#include <vector>
 
 namespace toy2d {
 
@@ -21,23 +23,24 @@ public:
 
 private:
     struct MemoryInfo {
-        size_t size;
-        std::optional<uint32_t> memoryTypeIndex;
+        std::vector<MemoryRequest> requests; // fallback chain, the first one that can be satisfied wins
         vk::BufferUsageFlags usage;
-        vk::MemoryPropertyFlags property;
+        vk::MemoryPropertyFlags property;    // of the memory type actually picked
     };
 
     MemoryInfo memoryInfo;
+    vk::DeviceAddress _deviceAddress = 0;
 
 public:
     Buffer(size_t size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags property);
+    Buffer(size_t size, vk::BufferUsageFlags usage, std::vector<MemoryRequest> requests);
     ~Buffer();
 
-    static std::optional<size_t> QueryMemoryTypeIndex(uint32_t type, vk::MemoryPropertyFlags propertyFlags);
+    vk::DeviceAddress getDeviceAddress() const; // buffers created with eShaderDeviceAddress only
+    vk::MemoryPropertyFlags getMemoryProperty() const;
 
 private:
     void createBuffer();
-    void queryMemoryInfo();
     void allocMemory();
     void bindMemoryToBuffer();
 };
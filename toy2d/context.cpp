@@ -7,6 +7,9 @@
 
 #include "context.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <utility>
 #include <vector>
@@ -15,6 +18,17 @@
 
 namespace toy2d {
 
+namespace {
+
+// push a feature struct to the front of a pNext chain
+template <typename T>
+void chainFeature(void*& head, T& feature) {
+    feature.setPNext(head);
+    head = &feature;
+}
+
+}
+
 std::unique_ptr<Context> Context::_instance = nullptr;
 
 void Context::Init(const std::vector<const char*>& extensions, CreateSurfaceFunc createSurface) {
@@ -34,14 +48,40 @@ Context::Context(const std::vector<const char*>& extensions, CreateSurfaceFunc c
     queryQueueFamilyIndices();
     createDevice();
     getQueues();
+    createPipelineCache();
 }
 
 Context::~Context() noexcept {
+    device.destroyPipelineCache(pipelineCache);
     instance.destroySurfaceKHR(surface);
     device.destroy();
     instance.destroy();
 }
 
+void Context::InitMemoryManager() {
+    memoryManager.reset(new MemoryManager);
+}
+
+void Context::DestroyMemoryManager() {
+    memoryManager.reset();
+}
+
+void Context::InitStagingRing(vk::DeviceSize capacity) {
+    stagingRing.reset(new StagingRing(capacity));
+}
+
+void Context::DestroyStagingRing() {
+    stagingRing.reset();
+}
+
+void Context::InitLayoutCache() {
+    layoutCache.reset(new LayoutCache);
+}
+
+void Context::DestroyLayoutCache() {
+    layoutCache.reset();
+}
+
 void Context::InitSwapchain(int w, int h) {
     swapchain.reset(new Swapchain(w, h));
 }
@@ -50,14 +90,22 @@ void Context::DestroySwapchain() {
     swapchain.reset();
 }
 
-void Context::InitRenderProcess(int w, int h) {
-    renderProcess.reset(new RenderProcess(w, h));
+void Context::InitRenderProcess() {
+    renderProcess.reset(new RenderProcess);
 }
 
 void Context::DestroyRenderProcess() {
     renderProcess.reset();
 }
 
+void Context::InitPipelineRegistry() {
+    pipelineRegistry.reset(new PipelineRegistry);
+}
+
+void Context::DestroyPipelineRegistry() {
+    pipelineRegistry.reset();
+}
+
 void Context::CreateFramebuffers(int w, int h) {
     swapchain->createFramebuffers(w, h);
 }
@@ -78,6 +126,34 @@ void Context::DestroyRenderer() {
     renderer.reset();
 }
 
+void Context::InitShaderReloader(const std::vector<ShaderReloader::WatchedProgram>& programs) {
+    shaderReloader.reset(new ShaderReloader(programs));
+}
+
+void Context::DestroyShaderReloader() {
+    shaderReloader.reset();
+}
+
+void Context::InitAssets(const std::vector<std::string>& packs) {
+    assets.reset(new AssetLoader);
+    for (const auto& pack : packs) {
+        // packs are optional, without one every asset is read from its own file
+        if (std::filesystem::exists(pack)) assets->Mount(pack);
+    }
+}
+
+void Context::DestroyAssets() {
+    assets.reset();
+}
+
+void Context::InitTextureCache(const std::filesystem::path& directory) {
+    textureCache.reset(new TextureCache(directory));
+}
+
+void Context::DestroyTextureCache() {
+    textureCache.reset();
+}
+
 void Context::createInstance(const std::vector<const char*>& extensions) {
     vk::InstanceCreateInfo createInfo;
     std::vector<const char*> layers;
@@ -149,7 +225,7 @@ void Context::createDevice() {
     vk::DeviceCreateInfo deviceCreateInfo;
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
     float priorities[] = {1.0f};
-    std::array extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    std::vector<const char*> extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
     // only one queue if graphics queue and present queue are the same
     if (queueFamilyIndices.graphicsQueue == queueFamilyIndices.presentQueue) {
@@ -174,7 +250,75 @@ void Context::createDevice() {
         queueCreateInfos.push_back(presentQueueCreateInfo);
     }
 
+    // optional extensions
+    auto available = phyDevice.enumerateDeviceExtensionProperties();
+    auto isSupported = [&](const char* name) {
+        return std::ranges::any_of(available, [&](const vk::ExtensionProperties& property) {
+            return std::strcmp(property.extensionName.data(), name) == 0;
+        });
+    };
+
+    // query only the feature structs of extensions the device knows about
+    vk::PhysicalDeviceFeatures2 supported;
+    vk::PhysicalDevicePresentIdFeaturesKHR presentIdSupported;
+    vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitSupported;
+    void* queryChain = nullptr;
+    if (isSupported(VK_KHR_PRESENT_ID_EXTENSION_NAME) && isSupported(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        chainFeature(queryChain, presentIdSupported);
+        chainFeature(queryChain, presentWaitSupported);
+    }
+    // 1.2 and 1.3 core features, the instance asks for 1.4 but the device may be older
+    auto apiVersion = phyDevice.getProperties().apiVersion;
+    vk::PhysicalDeviceVulkan12Features vulkan12Supported;
+    vk::PhysicalDeviceVulkan13Features vulkan13Supported;
+    bool isVulkan12 = apiVersion >= VK_API_VERSION_1_2;
+    bool isVulkan13 = apiVersion >= VK_API_VERSION_1_3;
+    if (isVulkan12) chainFeature(queryChain, vulkan12Supported);
+    if (isVulkan13) chainFeature(queryChain, vulkan13Supported);
+    supported.setPNext(queryChain);
+    phyDevice.getFeatures2(&supported);
+
+    // enable only the features we use
+    vk::PhysicalDeviceFeatures2 enabled;
+    vk::PhysicalDevicePresentIdFeaturesKHR presentIdEnabled;
+    vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitEnabled;
+    vk::PhysicalDeviceVulkan12Features vulkan12Enabled;
+    vk::PhysicalDeviceVulkan13Features vulkan13Enabled;
+    void* enableChain = nullptr;
+
+    if (presentIdSupported.presentId && presentWaitSupported.presentWait) {
+        extensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        extensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        chainFeature(enableChain, presentIdEnabled.setPresentId(true));
+        chainFeature(enableChain, presentWaitEnabled.setPresentWait(true));
+        features.presentWait = true;
+    }
+    if (isSupported(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME)) {
+        extensions.push_back(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+        features.displayTiming = true;
+    }
+    if (isSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        features.memoryBudget = true;
+    }
+    if (isVulkan13 && vulkan13Supported.dynamicRendering) {
+        vulkan13Enabled.setDynamicRendering(true);
+        features.dynamicRendering = true;
+    }
+    if (isVulkan13 && vulkan13Supported.synchronization2) {
+        vulkan13Enabled.setSynchronization2(true);
+        features.synchronization2 = true;
+    }
+    if (isVulkan12 && vulkan12Supported.bufferDeviceAddress) {
+        vulkan12Enabled.setBufferDeviceAddress(true);
+        features.bufferDeviceAddress = true;
+    }
+    if (isVulkan12) chainFeature(enableChain, vulkan12Enabled);
+    if (isVulkan13) chainFeature(enableChain, vulkan13Enabled);
+    enabled.setPNext(enableChain);
+
     deviceCreateInfo
+    .setPNext(&enabled)
     .setQueueCreateInfos(queueCreateInfos)
     .setPEnabledExtensionNames(extensions);
 
@@ -201,4 +345,9 @@ void Context::getQueues() {
     presentQueue = device.getQueue(queueFamilyIndices.presentQueue.value(), 0);
 }
 
+void Context::createPipelineCache() {
+    vk::PipelineCacheCreateInfo createInfo;
+    pipelineCache = device.createPipelineCache(createInfo);
+}
+
 }
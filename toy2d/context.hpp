@@ -12,6 +12,13 @@
 #include "render_process.hpp"
 #include "renderer.hpp"
 #include "command_manager.hpp"
+#include "layout_cache.hpp"
+#include "shader_reloader.hpp"
+#include "pipeline_registry.hpp"
+#include "asset_pack.hpp"
+#include "texture_cache.hpp"
+#include "memory_manager.hpp"
+#include "staging_ring.hpp"
 
 #include "vulkan/vulkan.hpp"
 
@@ -30,19 +37,38 @@ public:
         operator bool() const { return graphicsQueue.has_value() && presentQueue.has_value(); }
     };
 
+    // optional device capabilities, enabled only if the physical device supports them
+    struct DeviceFeatures {
+        bool presentWait = false;   // VK_KHR_present_id + VK_KHR_present_wait
+        bool displayTiming = false; // VK_GOOGLE_display_timing
+        bool dynamicRendering = false; // core in 1.3, replaces render pass and framebuffer objects
+        bool synchronization2 = false; // core in 1.3, vkCmdPipelineBarrier2 for render graph barriers
+        bool bufferDeviceAddress = false; // core in 1.2, shaders read scene data through GPU pointers
+        bool memoryBudget = false; // VK_EXT_memory_budget, the driver's per heap budget and usage
+    };
+
     vk::Instance instance;
     vk::PhysicalDevice phyDevice;
     vk::Device device;
     vk::Queue graphicsQueue;
     vk::Queue presentQueue;
     vk::SurfaceKHR surface;
+    vk::PipelineCache pipelineCache; // shared by every pipeline creation, internally synchronized
 
+    std::unique_ptr<MemoryManager> memoryManager; // every device memory allocation goes through it
+    std::unique_ptr<StagingRing> stagingRing;     // every host to device copy reads from it
     std::unique_ptr<Swapchain> swapchain;
     std::unique_ptr<RenderProcess> renderProcess;
     std::unique_ptr<Renderer> renderer;
     std::unique_ptr<CommandManager> commandManager;
+    std::unique_ptr<LayoutCache> layoutCache;
+    std::unique_ptr<PipelineRegistry> pipelineRegistry;
+    std::unique_ptr<ShaderReloader> shaderReloader;
+    std::unique_ptr<AssetLoader> assets;
+    std::unique_ptr<TextureCache> textureCache;
 
     QueueFamilyIndices queueFamilyIndices;
+    DeviceFeatures features;
 
 public:
     ~Context();
@@ -51,21 +77,36 @@ public:
     static void Init(const std::vector<const char*>& extensions, CreateSurfaceFunc createSurface);
     static void Quit();
 
+    void InitMemoryManager();
+    void DestroyMemoryManager();
+    void InitStagingRing(vk::DeviceSize capacity);
+    void DestroyStagingRing();
+    void InitLayoutCache();
+    void DestroyLayoutCache();
     void InitSwapchain(int w, int h);
     void DestroySwapchain();
-    void InitRenderProcess(int w, int h);
+    void InitRenderProcess();
     void DestroyRenderProcess();
+    void InitPipelineRegistry();
+    void DestroyPipelineRegistry();
     void CreateFramebuffers(int w, int h);
     void InitCommandManager();
     void DestroyCommandManager();
     void InitRenderer();
     void DestroyRenderer();
+    void InitShaderReloader(const std::vector<ShaderReloader::WatchedProgram>& programs);
+    void DestroyShaderReloader();
+    void InitAssets(const std::vector<std::string>& packs);
+    void DestroyAssets();
+    void InitTextureCache(const std::filesystem::path& directory);
+    void DestroyTextureCache();
 
     void createInstance(const std::vector<const char*>& extensions);
     void pickupPhysicalDevice();
     void createDevice();
     void queryQueueFamilyIndices();
     void getQueues();
+    void createPipelineCache();
 
 private:
     static std::unique_ptr<Context> _instance;
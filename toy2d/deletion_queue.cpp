@@ -0,0 +1,38 @@
+/**
+  * @file   deletion_queue.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "deletion_queue.hpp"
+
+#include <utility>
+
+namespace toy2d {
+
+DeletionQueue::DeletionQueue(size_t frameCount) : _slots(frameCount) {}
+
+DeletionQueue::~DeletionQueue() {
+    Flush();
+}
+
+void DeletionQueue::Push(std::function<void()> deleter) {
+    _slots[_current].push_back(std::move(deleter));
+}
+
+void DeletionQueue::BeginFrame(size_t slot) {
+    _current = slot;
+    // deleters may push again, e.g. a buffer freeing its own staging memory
+    auto deleters = std::exchange(_slots[slot], {});
+    for (auto& deleter : deleters) deleter();
+}
+
+void DeletionQueue::Flush() {
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        auto deleters = std::exchange(_slots[i], {});
+        for (auto& deleter : deleters) deleter();
+    }
+}
+
+}
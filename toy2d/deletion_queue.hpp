@@ -0,0 +1,32 @@
+/**
+  * @file   deletion_queue.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace toy2d {
+
+// destroys resources once the frame slot that last saw them comes round again,
+// i.e. after its fence was waited and no frame in flight can still read them
+class DeletionQueue {
+private:
+    std::vector<std::vector<std::function<void()>>> _slots;
+    size_t _current = 0;
+
+public:
+    explicit DeletionQueue(size_t frameCount);
+    DeletionQueue(const DeletionQueue&) = delete;
+    ~DeletionQueue();
+
+    void Push(std::function<void()> deleter); // runs when the current slot is flushed next time
+    void BeginFrame(size_t slot);              // after waiting the slot's fence, runs what it collected last time
+    void Flush();                               // everything, the device must be idle
+};
+
+}
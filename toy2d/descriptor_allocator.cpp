@@ -0,0 +1,154 @@
+/**
+  * @file   descriptor_allocator.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "descriptor_allocator.hpp"
+
+#include "context.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+
+namespace toy2d {
+
+DescriptorAllocator::DescriptorAllocator(uint32_t initialSets, std::vector<PoolSizeRatio> ratios)
+    : _ratios(std::move(ratios)), _setsPerPool(initialSets) {}
+
+DescriptorAllocator::~DescriptorAllocator() {
+    auto& device = Context::GetInstance().device;
+    for (auto& pool : _readyPools) device.destroyDescriptorPool(pool);
+    for (auto& pool : _fullPools) device.destroyDescriptorPool(pool);
+}
+
+std::vector<DescriptorAllocator::PoolSizeRatio> DescriptorAllocator::DefaultRatios() {
+    return {
+        { vk::DescriptorType::eUniformBufferDynamic, 1.0f },
+        { vk::DescriptorType::eUniformBuffer, 1.0f },
+        { vk::DescriptorType::eCombinedImageSampler, 1.0f },
+        { vk::DescriptorType::eStorageBuffer, 1.0f },
+    };
+}
+
+vk::DescriptorSet DescriptorAllocator::Allocate(vk::DescriptorSetLayout layout) {
+    auto& device = Context::GetInstance().device;
+    vk::DescriptorSetAllocateInfo allocInfo;
+    allocInfo.setSetLayouts(layout);
+
+    // a full or fragmented pool is retired and the allocation is retried once on a fresh one
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        auto pool = grabPool();
+        allocInfo.setDescriptorPool(pool);
+        try {
+            auto set = device.allocateDescriptorSets(allocInfo)[0];
+            _readyPools.push_back(pool);
+            return set;
+        } catch (const vk::OutOfPoolMemoryError&) {
+            _fullPools.push_back(pool);
+        } catch (const vk::FragmentedPoolError&) {
+            _fullPools.push_back(pool);
+        }
+    }
+    throw std::runtime_error("Failed to allocate descriptor set.");
+}
+
+void DescriptorAllocator::Reset() {
+    auto& device = Context::GetInstance().device;
+    for (auto& pool : _readyPools) device.resetDescriptorPool(pool);
+    for (auto& pool : _fullPools) {
+        device.resetDescriptorPool(pool);
+        _readyPools.push_back(pool);
+    }
+    _fullPools.clear();
+}
+
+vk::DescriptorPool DescriptorAllocator::grabPool() {
+    if (!_readyPools.empty()) {
+        auto pool = _readyPools.back();
+        _readyPools.pop_back();
+        return pool;
+    }
+
+    // grow geometrically so that a busy allocator settles on a few large pools
+    auto pool = createPool(_setsPerPool);
+    _setsPerPool = std::min(_setsPerPool * 2, maxSetsPerPool);
+    return pool;
+}
+
+vk::DescriptorPool DescriptorAllocator::createPool(uint32_t setCount) {
+    vk::DescriptorPoolCreateInfo createInfo;
+    std::vector<vk::DescriptorPoolSize> poolSizes;
+    for (const auto& ratio : _ratios) {
+        poolSizes.emplace_back(ratio.type, std::max(1u, static_cast<uint32_t>(ratio.ratio * setCount)));
+    }
+
+    createInfo
+    .setMaxSets(setCount)
+    .setPoolSizes(poolSizes);
+    return Context::GetInstance().device.createDescriptorPool(createInfo);
+}
+
+DescriptorCache::DescriptorCache() : _allocator(16) {}
+
+size_t DescriptorCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = 0;
+    HashCombine(seed, static_cast<VkDescriptorSetLayout>(key.layout));
+    for (const auto& binding : key.bindings) {
+        HashCombine(seed, binding.binding);
+        HashCombine(seed, binding.type);
+        HashCombine(seed, static_cast<VkBuffer>(binding.buffer.buffer));
+        HashCombine(seed, binding.buffer.offset);
+        HashCombine(seed, binding.buffer.range);
+        HashCombine(seed, static_cast<VkSampler>(binding.image.sampler));
+        HashCombine(seed, static_cast<VkImageView>(binding.image.imageView));
+        HashCombine(seed, binding.image.imageLayout);
+    }
+    return seed;
+}
+
+vk::DescriptorSet DescriptorCache::Get(vk::DescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings) {
+    Key key { layout, bindings };
+    if (auto it = _sets.find(key); it != _sets.end()) return it->second;
+
+    auto set = createSet(layout, bindings);
+    _sets.emplace(std::move(key), set);
+    return set;
+}
+
+void DescriptorCache::Clear() {
+    _sets.clear();
+    _allocator.Reset();
+}
+
+vk::DescriptorSet DescriptorCache::createSet(vk::DescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings) {
+    auto set = _allocator.Allocate(layout);
+
+    std::vector<vk::WriteDescriptorSet> writers(bindings.size());
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        const auto& binding = bindings[i];
+        writers[i]
+        .setDescriptorType(binding.type)
+        .setDescriptorCount(1)
+        .setDstSet(set)
+        .setDstBinding(binding.binding)
+        .setDstArrayElement(0);
+
+        switch (binding.type) {
+        case vk::DescriptorType::eUniformBuffer:
+        case vk::DescriptorType::eUniformBufferDynamic:
+        case vk::DescriptorType::eStorageBuffer:
+        case vk::DescriptorType::eStorageBufferDynamic:
+            writers[i].setPBufferInfo(&binding.buffer);
+            break;
+        default:
+            writers[i].setPImageInfo(&binding.image);
+            break;
+        }
+    }
+    Context::GetInstance().device.updateDescriptorSets(writers, {});
+    return set;
+}
+
+}
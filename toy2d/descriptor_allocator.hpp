@@ -0,0 +1,85 @@
+/**
+  * @file   descriptor_allocator.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace toy2d {
+
+// allocates descriptor sets from a list of pools, creating a bigger pool whenever the current one runs out
+class DescriptorAllocator {
+public:
+    struct PoolSizeRatio {
+        vk::DescriptorType type;
+        float ratio; // descriptors of this type per set
+    };
+
+private:
+    std::vector<PoolSizeRatio> _ratios;
+    uint32_t _setsPerPool;
+    std::vector<vk::DescriptorPool> _readyPools; // may still have room
+    std::vector<vk::DescriptorPool> _fullPools;
+
+    static constexpr uint32_t maxSetsPerPool = 4096;
+
+public:
+    DescriptorAllocator(uint32_t initialSets, std::vector<PoolSizeRatio> ratios = DefaultRatios());
+    ~DescriptorAllocator();
+
+    vk::DescriptorSet Allocate(vk::DescriptorSetLayout layout);
+    void Reset(); // frees every set at once, pools are kept for reuse
+
+    static std::vector<PoolSizeRatio> DefaultRatios();
+
+private:
+    vk::DescriptorPool grabPool();
+    vk::DescriptorPool createPool(uint32_t setCount);
+};
+
+// a descriptor write, either a buffer or an image depending on type
+struct DescriptorBinding {
+    uint32_t binding;
+    vk::DescriptorType type;
+    vk::DescriptorBufferInfo buffer;
+    vk::DescriptorImageInfo image;
+
+    bool operator==(const DescriptorBinding& other) const = default;
+};
+
+// immutable descriptor sets, allocated and written once per distinct (layout, bindings)
+class DescriptorCache {
+private:
+    struct Key {
+        vk::DescriptorSetLayout layout;
+        std::vector<DescriptorBinding> bindings;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    DescriptorAllocator _allocator;
+    std::unordered_map<Key, vk::DescriptorSet, KeyHash> _sets;
+
+public:
+    DescriptorCache();
+
+    vk::DescriptorSet Get(vk::DescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings);
+    void Clear(); // call after resources referenced by cached sets are destroyed
+
+private:
+    vk::DescriptorSet createSet(vk::DescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings);
+};
+
+}
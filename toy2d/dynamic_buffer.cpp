@@ -0,0 +1,312 @@
+/**
+  * @file   dynamic_buffer.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "dynamic_buffer.hpp"
+
+#include "context.hpp"
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace toy2d {
+
+DynamicBuffer::DynamicBuffer(vk::BufferUsageFlags usage, DeletionQueue& deletionQueue, Diff diff, size_t capacity)
+    : _usage(usage | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc), _deletionQueue(deletionQueue),
+      _unified(Context::GetInstance().memoryManager->HasUnifiedMemory()), _hostCopy(diff == Diff::HostCopy) {
+    if (capacity > 0) grow(capacity);
+}
+
+DynamicBuffer::~DynamicBuffer() {
+    // frames in flight may still read it
+    if (_buffer) _deletionQueue.Push([buffer = std::shared_ptr<Buffer>(std::move(_buffer))] {});
+}
+
+void DynamicBuffer::Reserve(size_t capacity) {
+    if (capacity > this->capacity()) grow(capacity);
+}
+
+void DynamicBuffer::Resize(size_t size) {
+    if (size > capacity()) grow(std::max(size, capacity() * 2));
+    if (_hostCopy) {
+        if (size > _contents.size()) markDirty(_contents.size(), size);
+        _contents.resize(size);
+        std::erase_if(_dirty, [size](const Range& range) { return range.begin >= size; });
+        for (auto& range : _dirty) range.end = std::min(range.end, size);
+    } else if (size > _size) {
+        stage(_size, nullptr, size - _size);
+    } else {
+        discard(size, std::numeric_limits<size_t>::max());
+    }
+    _size = size;
+}
+
+void DynamicBuffer::Update(size_t offset, const void* data, size_t size) {
+    if (size == 0) return;
+    if (_hostCopy) {
+        if (offset + size > _contents.size()) Resize(offset + size);
+        std::memcpy(_contents.data() + offset, data, size);
+        markDirty(offset, offset + size);
+        return;
+    }
+
+    // only a gap before the write needs zeros
+    if (offset + size > capacity()) grow(std::max(offset + size, capacity() * 2));
+    if (offset > _size) Resize(offset);
+    _size = std::max(_size, offset + size);
+    stage(offset, data, size);
+}
+
+void DynamicBuffer::Assign(const void* data, size_t size) {
+    if (!_hostCopy) {
+        // nothing to diff against and nothing old has to survive a grow, the whole range is staged
+        _pending.clear();
+        _size = 0;
+        if (size > capacity()) grow(std::max(size, capacity() * 2));
+        _size = size;
+        if (size > 0) stage(0, data, size);
+        return;
+    }
+
+    auto bytes = static_cast<const std::byte*>(data);
+    auto common = std::min(size, _contents.size());
+    Resize(size); // marks the tail
+
+    // a few moved vertices in a mostly static buffer cost a few blocks, not the whole buffer
+    for (size_t begin = 0; begin < common; begin += compareBlock) {
+        auto end = std::min(begin + compareBlock, common);
+        if (std::memcmp(_contents.data() + begin, bytes + begin, end - begin) != 0) markDirty(begin, end);
+    }
+    if (size > 0) std::memcpy(_contents.data(), bytes, size);
+}
+
+void DynamicBuffer::Flush(vk::CommandBuffer cmdBuf, bool inUse) {
+    _uploadedBytes = 0;
+    if (!dirty()) return;
+
+    // in place only when nothing may read or write the buffer on the GPU, frame fences do not cover lone submits
+    bool inPlace = _mapped && !inUse && !_unorderedCopy;
+
+    if (_hostCopy) {
+        // coalesce, a gap smaller than mergeGap is cheaper to copy than another region
+        std::ranges::sort(_dirty, {}, &Range::begin);
+        std::vector<Range> ranges { _dirty.front() };
+        for (const auto& range : _dirty) {
+            if (range.begin <= ranges.back().end + mergeGap) ranges.back().end = std::max(ranges.back().end, range.end);
+            else ranges.push_back(range);
+        }
+        _dirty.clear();
+
+        size_t total = 0;
+        for (const auto& range : ranges) total += range.end - range.begin;
+        _uploadedBytes = total;
+
+        if (inPlace) {
+            // coherent, the next submit makes the writes visible
+            for (const auto& range : ranges) {
+                std::memcpy(_mapped + range.begin, _contents.data() + range.begin, range.end - range.begin);
+            }
+            return;
+        }
+
+        auto staging = Context::GetInstance().stagingRing->Allocate(total);
+        size_t offset = 0;
+        for (const auto& range : ranges) {
+            auto size = range.end - range.begin;
+            std::memcpy(staging.data + offset, _contents.data() + range.begin, size);
+            _pending.push_back({ range.begin, size, staging.buffer, staging.offset + offset, staging.data + offset });
+            offset += size;
+        }
+    } else {
+        for (const auto& write : _pending) _uploadedBytes += write.size;
+        if (inPlace) {
+            for (const auto& write : _pending) std::memcpy(_mapped + write.offset, write.data, write.size);
+            _pending.clear();
+            return;
+        }
+    }
+
+    // one copy per source, writes that did not fit the ring were staged in an overflow buffer
+    std::ranges::sort(_pending, {}, &Write::source);
+    std::vector<std::pair<vk::Buffer, std::vector<vk::BufferCopy>>> copies;
+    for (const auto& write : _pending) {
+        if (copies.empty() || copies.back().first != write.source) copies.emplace_back(write.source, std::vector<vk::BufferCopy>());
+        copies.back().second.emplace_back(write.sourceOffset, write.offset, write.size);
+    }
+    _pending.clear();
+
+    auto copy = [&, dst = _buffer->buffer](vk::CommandBuffer cmdBuf) {
+        for (const auto& [src, regions] : copies) cmdBuf.copyBuffer(src, dst, regions);
+    };
+    if (cmdBuf) {
+        record(cmdBuf, copy);
+        _unorderedCopy = false; // its barrier waits for earlier submits, the frame fence then covers them all
+    } else {
+        submit(copy);
+    }
+}
+
+bool DynamicBuffer::dirty() const {
+    return !_dirty.empty() || !_pending.empty();
+}
+
+vk::Buffer DynamicBuffer::getBuffer() const {
+    return _buffer ? _buffer->buffer : vk::Buffer();
+}
+
+vk::DeviceAddress DynamicBuffer::getDeviceAddress() const {
+    if (!_buffer) throw std::runtime_error("Dynamic buffer has no storage yet.");
+    return _buffer->getDeviceAddress();
+}
+
+size_t DynamicBuffer::size() const {
+    return _size;
+}
+
+size_t DynamicBuffer::capacity() const {
+    return _buffer ? _buffer->size : 0;
+}
+
+size_t DynamicBuffer::getUploadedBytes() const {
+    return _uploadedBytes;
+}
+
+bool DynamicBuffer::isUnified() const {
+    return _unified;
+}
+
+void DynamicBuffer::grow(size_t capacity) {
+    // unified memory over budget ends up in plain device local memory, written through staging copies again
+    std::vector<MemoryRequest> requests;
+    if (_unified) requests.push_back(MemoryRequest::Unified());
+    requests.push_back(MemoryRequest::DeviceOnly());
+    auto grown = std::make_unique<Buffer>(std::max(capacity, minCapacity), _usage, std::move(requests));
+    auto old = std::move(_buffer);
+    _buffer = std::move(grown);
+
+    auto hostWritable = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    _mapped = nullptr;
+    bool written = false;
+    if ((_buffer->getMemoryProperty() & hostWritable) == hostWritable) {
+        // freeing the old memory unmaps it
+        _mapped = static_cast<std::byte*>(Context::GetInstance().device.mapMemory(_buffer->memory, 0, VK_WHOLE_SIZE));
+        if (_hostCopy) {
+            // nothing reads the new buffer yet, the host copy goes straight in, dirty ranges included
+            if (!_contents.empty()) std::memcpy(_mapped, _contents.data(), _contents.size());
+            _dirty.clear();
+            written = true;
+        }
+    }
+    if (!old) return;
+
+    // without a host copy only the old buffer has everything flushed so far.
+    // ranges still dirty or staged are copied at the next flush, on top of this
+    if (!written && _size > 0) {
+        submit([src = old->buffer, dst = _buffer->buffer, size = _size](vk::CommandBuffer cmdBuf) {
+            vk::BufferCopy region;
+            region.setSrcOffset(0).setDstOffset(0).setSize(size);
+            cmdBuf.copyBuffer(src, dst, region);
+        });
+    }
+    // frames in flight and the copy above still read it
+    _deletionQueue.Push([old = std::shared_ptr<Buffer>(std::move(old))] {});
+}
+
+void DynamicBuffer::markDirty(size_t begin, size_t end) {
+    if (begin < end) _dirty.push_back({ begin, end });
+}
+
+void DynamicBuffer::stage(size_t offset, const void* data, size_t size) {
+    auto write = [&](std::byte* target) {
+        if (data) std::memcpy(target, data, size);
+        else std::memset(target, 0, size);
+    };
+
+    // rewriting staged bytes needs no new space
+    for (const auto& pending : _pending) {
+        if (offset >= pending.offset && offset + size <= pending.offset + pending.size) {
+            write(pending.data + (offset - pending.offset));
+            return;
+        }
+    }
+
+    discard(offset, offset + size); // the newer bytes win
+    auto staging = Context::GetInstance().stagingRing->Allocate(size);
+    write(staging.data);
+    _pending.push_back({ offset, size, staging.buffer, staging.offset, staging.data });
+}
+
+void DynamicBuffer::discard(size_t begin, size_t end) {
+    std::vector<Write> kept;
+    for (const auto& pending : _pending) {
+        auto pendingEnd = pending.offset + pending.size;
+        if (pendingEnd <= begin || pending.offset >= end) {
+            kept.push_back(pending);
+            continue;
+        }
+        // keep what sticks out on either side
+        if (pending.offset < begin) {
+            kept.push_back({ pending.offset, begin - pending.offset, pending.source, pending.sourceOffset, pending.data });
+        }
+        if (pendingEnd > end) {
+            auto skip = end - pending.offset;
+            kept.push_back({ end, pendingEnd - end, pending.source, pending.sourceOffset + skip, pending.data + skip });
+        }
+    }
+    _pending = std::move(kept);
+}
+
+void DynamicBuffer::record(vk::CommandBuffer cmdBuf, const std::function<void(vk::CommandBuffer cmdBuf)>& copy) {
+    // earlier frames may still read the ranges being written, later ones must see the result
+    vk::MemoryBarrier2 before;
+    before
+    .setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+    .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+    .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+    .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    vk::MemoryBarrier2 after;
+    after
+    .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+    .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+    .setDstStageMask(vk::PipelineStageFlagBits2::eVertexInput | vk::PipelineStageFlagBits2::eVertexShader |
+                     vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eTransfer)
+    .setDstAccessMask(vk::AccessFlagBits2::eVertexAttributeRead | vk::AccessFlagBits2::eIndexRead |
+                      vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eUniformRead |
+                      vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite);
+
+    RenderGraph::PipelineBarrier(cmdBuf, {}, { before });
+    copy(cmdBuf);
+    RenderGraph::PipelineBarrier(cmdBuf, {}, { after });
+}
+
+void DynamicBuffer::submit(const std::function<void(vk::CommandBuffer cmdBuf)>& copy) {
+    auto& ctx = Context::GetInstance();
+    auto cmdBuf = ctx.commandManager->AllocCommandBuffer();
+
+    vk::CommandBufferBeginInfo beginInfo;
+    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    cmdBuf.begin(beginInfo); {
+        record(cmdBuf, copy);
+    } cmdBuf.end();
+
+    auto fence = ctx.device.createFence({});
+    vk::SubmitInfo submitInfo;
+    submitInfo.setCommandBuffers(cmdBuf);
+    ctx.graphicsQueue.submit(submitInfo, fence);
+    _unorderedCopy = true; // until a copy recorded into a frame orders itself after this one
+
+    // long done when the slot comes round again, the wait only makes that a guarantee
+    _deletionQueue.Push([cmdBuf, fence] {
+        auto& ctx = Context::GetInstance();
+        (void)ctx.device.waitForFences(fence, true, std::numeric_limits<uint64_t>::max());
+        ctx.device.destroyFence(fence);
+        ctx.commandManager->FreeCommandBuffer(cmdBuf);
+    });
+}
+
+}
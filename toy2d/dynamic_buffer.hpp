@@ -0,0 +1,98 @@
+/**
+  * @file   dynamic_buffer.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "buffer.hpp"
+#include "deletion_queue.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace toy2d {
+
+// a device local buffer whose size is not known up front:
+// grows geometrically, keeps its contents across growth (GPU copy) and hands the old storage to the deletion queue.
+// writes are staged in the staging ring and copied at the next Flush(). buffers created with Diff::HostCopy keep
+// a copy of their contents instead, Assign() diffs against it and only the byte ranges that changed are uploaded.
+// with unified memory (integrated GPUs, resizable BAR) the buffer stays mapped and an idle buffer is written in place
+class DynamicBuffer {
+public:
+    static constexpr size_t minCapacity = 256;
+    static constexpr size_t compareBlock = 64; // Assign() diffs in blocks of this many bytes
+    static constexpr size_t mergeGap = 256;    // dirty ranges closer than this are copied as one region
+
+    // what Assign() compares the new contents with
+    enum class Diff {
+        None,     // nothing, the whole range is staged
+        HostCopy, // a host copy of the contents, for mostly static data rewritten as a whole
+    };
+
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    // bytes in the staging ring waiting for Flush(), never overlapping as copy regions must not
+    struct Write {
+        size_t offset;
+        size_t size;
+        vk::Buffer source;
+        size_t sourceOffset;
+        std::byte* data;
+    };
+
+    vk::BufferUsageFlags _usage;
+    DeletionQueue& _deletionQueue;
+    std::unique_ptr<Buffer> _buffer;
+    bool _unified;                     // device local memory is host visible
+    bool _hostCopy;                    // keeps _contents to diff against
+    std::byte* _mapped = nullptr;      // persistently, unified memory only
+    size_t _size = 0;
+    std::vector<std::byte> _contents;  // host copy: what the buffer holds once the dirty ranges are flushed
+    std::vector<Range> _dirty;         // host copy: changed since the last Flush()
+    std::vector<Write> _pending;       // without host copy: staged since the last Flush()
+    bool _unorderedCopy = false;       // a copy submitted on its own may still write the buffer, no frame fence covers it
+    size_t _uploadedBytes = 0;         // by the last Flush(), for stats
+
+public:
+    DynamicBuffer(vk::BufferUsageFlags usage, DeletionQueue& deletionQueue, Diff diff = Diff::None, size_t capacity = 0);
+    DynamicBuffer(const DynamicBuffer&) = delete;
+    ~DynamicBuffer();
+
+    void Reserve(size_t capacity); // never shrinks
+    void Resize(size_t size);      // new bytes are zero
+    void Update(size_t offset, const void* data, size_t size); // grows to offset + size if needed
+    void Assign(const void* data, size_t size);                // replaces the contents, with Diff::HostCopy only what differs is uploaded
+
+    // records the copies of all dirty ranges, outside of a render pass. with a null command buffer they are submitted on their own.
+    // inUse tells whether submitted work may still read the buffer, if not unified memory is written in place
+    void Flush(vk::CommandBuffer cmdBuf = nullptr, bool inUse = true);
+    bool dirty() const;
+
+    vk::Buffer getBuffer() const; // changes when the buffer grows
+    vk::DeviceAddress getDeviceAddress() const;
+    size_t size() const;
+    size_t capacity() const;
+    size_t getUploadedBytes() const;
+    bool isUnified() const;
+
+private:
+    void grow(size_t capacity);
+    void markDirty(size_t begin, size_t end);
+    void stage(size_t offset, const void* data, size_t size); // null data stages zeros
+    void discard(size_t begin, size_t end);                   // drops the staged bytes of a range
+    void record(vk::CommandBuffer cmdBuf, const std::function<void(vk::CommandBuffer cmdBuf)>& copy);
+    void submit(const std::function<void(vk::CommandBuffer cmdBuf)>& copy);
+};
+
+}
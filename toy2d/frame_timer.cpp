@@ -0,0 +1,217 @@
+/**
+  * @file   frame_timer.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "frame_timer.hpp"
+
+#include "context.hpp"
+
+#include <algorithm>
+#include <format>
+#include <vector>
+
+namespace toy2d {
+
+void LatencyHistogram::Record(Duration latency) {
+    if (latency < Duration::zero()) latency = Duration::zero();
+    auto bucket = std::min<size_t>(latency / bucketWidth, bucketCount - 1);
+    ++_buckets[bucket];
+    ++_count;
+    _sum += latency;
+    _min = std::min(_min, latency);
+    _max = std::max(_max, latency);
+}
+
+void LatencyHistogram::Reset() {
+    *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return _count;
+}
+
+LatencyHistogram::Duration LatencyHistogram::getPercentile(double percentile) const {
+    if (_count == 0) return Duration::zero();
+    auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(_count - 1)) + 1;
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        accumulated += _buckets[i];
+        if (accumulated >= target) return std::min(bucketUpperEdge(i), _max);
+    }
+    return _max;
+}
+
+LatencyHistogram::Duration LatencyHistogram::bucketUpperEdge(size_t bucket) {
+    return bucketWidth * static_cast<Duration::rep>(bucket + 1);
+}
+
+void LatencyHistogram::Report(std::ostream& os, std::string_view name) const {
+    auto ms = [](Duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    if (_count == 0) {
+        os << std::format("{:<18} no samples", name) << std::endl;
+        return;
+    }
+    os << std::format("{:<18} n={:<6} min={:7.2f}ms mean={:7.2f}ms p50={:7.2f}ms p90={:7.2f}ms p99={:7.2f}ms max={:7.2f}ms",
+                      name, _count, ms(_min), ms(_sum / _count),
+                      ms(getPercentile(50)), ms(getPercentile(90)), ms(getPercentile(99)), ms(_max)) << std::endl;
+
+    // one row per non-empty bucket, bar scaled to the fullest bucket
+    auto peak = *std::max_element(_buckets.begin(), _buckets.end());
+    for (size_t i = 0; i < bucketCount; ++i) {
+        if (_buckets[i] == 0) continue;
+        auto width = static_cast<size_t>((_buckets[i] * 40 + peak - 1) / peak);
+        os << std::format("  {:>7.2f}ms{} {:<40} {}",
+                          ms(bucketUpperEdge(i)), i + 1 == bucketCount ? "+" : " ",
+                          std::string(width, '#'), _buckets[i]) << std::endl;
+    }
+}
+
+FrameTimer::FrameTimer() {
+    auto& ctx = Context::GetInstance();
+
+    // prefer the actual photon time if the driver reports it
+    if (ctx.features.displayTiming) {
+        _getPastPresentationTiming = reinterpret_cast<PFN_vkGetPastPresentationTimingGOOGLE>(
+            ctx.device.getProcAddr("vkGetPastPresentationTimingGOOGLE"));
+        if (_getPastPresentationTiming) _source = PresentSource::DisplayTiming;
+    }
+    if (_source == PresentSource::CPU && ctx.features.presentWait) {
+        _waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(ctx.device.getProcAddr("vkWaitForPresentKHR"));
+        if (_waitForPresent) _source = PresentSource::PresentWait;
+    }
+}
+
+void FrameTimer::MarkInput() {
+    // keep the oldest unserved input, it has waited the longest
+    if (!_pendingInput.has_value()) _pendingInput = Clock::now();
+}
+
+void FrameTimer::MarkAcquire() {
+    _current = FrameTimestamps();
+    _current.acquire = Clock::now();
+    _current.input = _pendingInput;
+    _pendingInput.reset();
+}
+
+void FrameTimer::MarkSubmit() {
+    _current.submit = Clock::now();
+}
+
+void FrameTimer::AttachPresentInfo(vk::PresentInfoKHR& present) {
+    _current.presentId = ++_presentCounter;
+
+    switch (_source) {
+    case PresentSource::DisplayTiming:
+        _presentTime
+        .setPresentID(static_cast<uint32_t>(_current.presentId))
+        .setDesiredPresentTime(0); // as soon as possible
+        _presentTimesInfo
+        .setTimes(_presentTime)
+        .setPNext(present.pNext);
+        present.setPNext(&_presentTimesInfo);
+        break;
+    case PresentSource::PresentWait:
+        _presentIdValue = _current.presentId;
+        _presentIdInfo
+        .setPresentIds(_presentIdValue)
+        .setPNext(present.pNext);
+        present.setPNext(&_presentIdInfo);
+        break;
+    case PresentSource::CPU:
+        break;
+    }
+}
+
+void FrameTimer::MarkPresent() {
+    _current.present = Clock::now();
+    if (_source == PresentSource::CPU) {
+        _current.displayed = _current.present;
+        retire(_current);
+        return;
+    }
+    _inFlight.push_back(_current);
+}
+
+void FrameTimer::Poll() {
+    if (_source == PresentSource::DisplayTiming) pollDisplayTiming();
+    if (_source == PresentSource::PresentWait) pollPresentWait();
+
+    // frames complete in present order, retire the resolved head
+    while (!_inFlight.empty() && (_inFlight.front().displayed.has_value() || _inFlight.size() > maxInFlight)) {
+        retire(_inFlight.front());
+        _inFlight.pop_front();
+    }
+}
+
+void FrameTimer::pollDisplayTiming() {
+    auto& ctx = Context::GetInstance();
+    VkDevice device = ctx.device;
+    VkSwapchainKHR swapchain = ctx.swapchain->swapchain;
+
+    uint32_t count = 0;
+    if (_getPastPresentationTiming(device, swapchain, &count, nullptr) != VK_SUCCESS || count == 0) return;
+    std::vector<VkPastPresentationTimingGOOGLE> timings(count);
+    if (_getPastPresentationTiming(device, swapchain, &count, timings.data()) < VK_SUCCESS) return;
+    timings.resize(count);
+
+    // actualPresentTime is reported on CLOCK_MONOTONIC, the same clock as steady_clock on our platforms
+    for (const auto& timing : timings) {
+        for (auto& frame : _inFlight) {
+            if (static_cast<uint32_t>(frame.presentId) != timing.presentID) continue;
+            frame.displayed = Clock::time_point(std::chrono::nanoseconds(timing.actualPresentTime));
+            break;
+        }
+    }
+}
+
+void FrameTimer::pollPresentWait() {
+    auto& ctx = Context::GetInstance();
+    VkDevice device = ctx.device;
+    VkSwapchainKHR swapchain = ctx.swapchain->swapchain;
+
+    // non-blocking wait, so the timestamp is an upper bound with one-frame granularity
+    auto now = Clock::now();
+    for (auto& frame : _inFlight) {
+        if (frame.displayed.has_value()) continue;
+        if (_waitForPresent(device, swapchain, frame.presentId, 0) != VK_SUCCESS) break;
+        frame.displayed = now;
+    }
+}
+
+void FrameTimer::retire(const FrameTimestamps& frame) {
+    _acquireToSubmit.Record(frame.submit - frame.acquire);
+    _submitToPresent.Record(frame.present - frame.submit);
+    if (!frame.displayed.has_value()) return; // timed out, only CPU-side stages are known
+
+    _presentToPhoton.Record(*frame.displayed - frame.present);
+    _acquireToPhoton.Record(*frame.displayed - frame.acquire);
+    if (frame.input.has_value()) _inputToPhoton.Record(*frame.displayed - *frame.input);
+}
+
+FrameTimer::PresentSource FrameTimer::getPresentSource() const {
+    return _source;
+}
+
+void FrameTimer::Report(std::ostream& os) const {
+    constexpr std::string_view sourceNames[] = { "CPU fallback", "VK_KHR_present_wait", "VK_GOOGLE_display_timing" };
+    os << "Frame latency (present timing: " << sourceNames[static_cast<int>(_source)] << "):" << std::endl;
+    _inputToPhoton.Report(os, "input -> photon");
+    _acquireToSubmit.Report(os, "acquire -> submit");
+    _submitToPresent.Report(os, "submit -> present");
+    _presentToPhoton.Report(os, "present -> photon");
+    _acquireToPhoton.Report(os, "acquire -> photon");
+}
+
+void FrameTimer::Reset() {
+    _inputToPhoton.Reset();
+    _acquireToSubmit.Reset();
+    _submitToPresent.Reset();
+    _presentToPhoton.Reset();
+    _acquireToPhoton.Reset();
+}
+
+}
@@ -0,0 +1,112 @@
+/**
+  * @file   frame_timer.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <cstdint>
+
+namespace toy2d {
+
+class LatencyHistogram {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    static constexpr Duration bucketWidth = std::chrono::microseconds(250);
+    static constexpr size_t bucketCount = 400; // 0 ~ 100ms, the last bucket also collects overflow
+
+private:
+    std::array<uint64_t, bucketCount> _buckets {};
+    uint64_t _count = 0;
+    Duration _sum {0};
+    Duration _min = Duration::max();
+    Duration _max {0};
+
+public:
+    void Record(Duration latency);
+    void Reset();
+
+    uint64_t getCount() const;
+    Duration getPercentile(double percentile) const; // upper edge of the bucket holding the percentile
+    void Report(std::ostream& os, std::string_view name) const;
+
+private:
+    static Duration bucketUpperEdge(size_t bucket);
+};
+
+class FrameTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // where the "displayed" timestamp of a frame comes from
+    enum class PresentSource {
+        CPU,            // when vkQueuePresentKHR returned
+        PresentWait,    // VK_KHR_present_wait, polled once per frame
+        DisplayTiming,  // VK_GOOGLE_display_timing, actual present time reported by the driver
+    };
+
+    struct FrameTimestamps {
+        uint64_t presentId = 0;
+        std::optional<Clock::time_point> input;
+        Clock::time_point acquire;
+        Clock::time_point submit;
+        Clock::time_point present;
+        std::optional<Clock::time_point> displayed;
+    };
+
+private:
+    PresentSource _source = PresentSource::CPU;
+    PFN_vkWaitForPresentKHR _waitForPresent = nullptr;
+    PFN_vkGetPastPresentationTimingGOOGLE _getPastPresentationTiming = nullptr;
+
+    std::optional<Clock::time_point> _pendingInput;
+    FrameTimestamps _current;
+    std::deque<FrameTimestamps> _inFlight; // presented but not yet known to be displayed
+    uint64_t _presentCounter = 0;
+
+    // chained into vk::PresentInfoKHR, must outlive the present call
+    uint64_t _presentIdValue = 0;
+    vk::PresentIdKHR _presentIdInfo;
+    vk::PresentTimeGOOGLE _presentTime;
+    vk::PresentTimesInfoGOOGLE _presentTimesInfo;
+
+    LatencyHistogram _inputToPhoton;
+    LatencyHistogram _acquireToSubmit;
+    LatencyHistogram _submitToPresent;
+    LatencyHistogram _presentToPhoton;
+    LatencyHistogram _acquireToPhoton;
+
+    static constexpr size_t maxInFlight = 64; // give up waiting for display timing after this many frames
+
+public:
+    FrameTimer();
+
+    void MarkInput();
+    void MarkAcquire();
+    void MarkSubmit();
+    void AttachPresentInfo(vk::PresentInfoKHR& present);
+    void MarkPresent();
+    void Poll();
+
+    PresentSource getPresentSource() const;
+    void Report(std::ostream& os) const;
+    void Reset();
+
+private:
+    void pollDisplayTiming();
+    void pollPresentWait();
+    void retire(const FrameTimestamps& frame);
+};
+
+}
@@ -0,0 +1,77 @@
+/**
+  * @file   layout_cache.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "layout_cache.hpp"
+
+#include "context.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+
+namespace toy2d {
+
+LayoutCache::~LayoutCache() {
+    auto& device = Context::GetInstance().device;
+    for (auto& [key, layout] : _pipelineLayouts) device.destroyPipelineLayout(layout);
+    for (auto& [key, layout] : _setLayouts) device.destroyDescriptorSetLayout(layout);
+}
+
+size_t LayoutCache::KeyHash::operator()(const SetLayoutKey& key) const {
+    size_t seed = 0;
+    for (const auto& binding : key.bindings) {
+        HashCombine(seed, binding.binding);
+        HashCombine(seed, binding.descriptorType);
+        HashCombine(seed, binding.descriptorCount);
+        HashCombine(seed, static_cast<VkShaderStageFlags>(binding.stageFlags));
+    }
+    return seed;
+}
+
+size_t LayoutCache::KeyHash::operator()(const PipelineLayoutKey& key) const {
+    size_t seed = 0;
+    for (const auto& layout : key.setLayouts) {
+        HashCombine(seed, static_cast<VkDescriptorSetLayout>(layout));
+    }
+    for (const auto& range : key.pushConstantRanges) {
+        HashCombine(seed, static_cast<VkShaderStageFlags>(range.stageFlags));
+        HashCombine(seed, range.offset);
+        HashCombine(seed, range.size);
+    }
+    return seed;
+}
+
+vk::DescriptorSetLayout LayoutCache::GetDescriptorSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings) {
+    // binding order does not change the layout
+    std::ranges::sort(bindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+
+    SetLayoutKey key { std::move(bindings) };
+    std::lock_guard lock(_mutex);
+    if (auto it = _setLayouts.find(key); it != _setLayouts.end()) return it->second;
+
+    vk::DescriptorSetLayoutCreateInfo createInfo;
+    createInfo.setBindings(key.bindings);
+    auto layout = Context::GetInstance().device.createDescriptorSetLayout(createInfo);
+    _setLayouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+vk::PipelineLayout LayoutCache::GetPipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts,
+                                                  const std::vector<vk::PushConstantRange>& pushConstantRanges) {
+    PipelineLayoutKey key { setLayouts, pushConstantRanges };
+    std::lock_guard lock(_mutex);
+    if (auto it = _pipelineLayouts.find(key); it != _pipelineLayouts.end()) return it->second;
+
+    vk::PipelineLayoutCreateInfo createInfo;
+    createInfo
+    .setSetLayouts(key.setLayouts)
+    .setPushConstantRanges(key.pushConstantRanges);
+    auto layout = Context::GetInstance().device.createPipelineLayout(createInfo);
+    _pipelineLayouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+}
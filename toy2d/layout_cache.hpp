@@ -0,0 +1,52 @@
+/**
+  * @file   layout_cache.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace toy2d {
+
+// deduplicates layout objects by content, equal descriptions always give the same handle,
+// so pipelines built from equal interfaces are layout compatible and can share descriptor sets
+class LayoutCache {
+private:
+    struct SetLayoutKey {
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+
+        bool operator==(const SetLayoutKey& other) const = default;
+    };
+
+    struct PipelineLayoutKey {
+        std::vector<vk::DescriptorSetLayout> setLayouts;
+        std::vector<vk::PushConstantRange> pushConstantRanges;
+
+        bool operator==(const PipelineLayoutKey& other) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const SetLayoutKey& key) const;
+        size_t operator()(const PipelineLayoutKey& key) const;
+    };
+
+    std::unordered_map<SetLayoutKey, vk::DescriptorSetLayout, KeyHash> _setLayouts;
+    std::unordered_map<PipelineLayoutKey, vk::PipelineLayout, KeyHash> _pipelineLayouts;
+    std::mutex _mutex; // shaders and pipelines may be built on worker threads
+
+public:
+    ~LayoutCache();
+
+    vk::DescriptorSetLayout GetDescriptorSetLayout(std::vector<vk::DescriptorSetLayoutBinding> bindings);
+    vk::PipelineLayout GetPipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts,
+                                         const std::vector<vk::PushConstantRange>& pushConstantRanges);
+};
+
+}
@@ -0,0 +1,160 @@
+/**
+  * @file   mapped_file.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace toy2d {
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(std::string path, Hint hint) : _path(std::move(path)) {
+    DWORD flags = hint == Hint::Random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file: " + _path);
+    }
+    _file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        unmap();
+        throw std::runtime_error("Failed to query file size: " + _path);
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) return; // empty files cannot be mapped
+
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) {
+        unmap();
+        throw std::runtime_error("Failed to map file: " + _path);
+    }
+    _data = static_cast<const std::byte*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!_data) {
+        unmap();
+        throw std::runtime_error("Failed to map file: " + _path);
+    }
+
+#if _WIN32_WINNT >= 0x0602
+    if (hint != Hint::Random) {
+        WIN32_MEMORY_RANGE_ENTRY range { const_cast<std::byte*>(_data), _size };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0); // only a hint, failure is fine
+    }
+#endif
+}
+
+void MappedFile::unmap() noexcept {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+    if (_file) CloseHandle(_file);
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+}
+
+#else
+
+MappedFile::MappedFile(std::string path, Hint hint) : _path(std::move(path)) {
+    int fd = open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + _path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to query file size: " + _path);
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size == 0) { // empty files cannot be mapped
+        close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        _size = 0;
+        throw std::runtime_error("Failed to map file: " + _path);
+    }
+    _data = static_cast<const std::byte*>(mapped);
+
+    int advice = MADV_SEQUENTIAL;
+    switch (hint) {
+    case Hint::Sequential: advice = MADV_SEQUENTIAL; break;
+    case Hint::WillNeed:   advice = MADV_WILLNEED; break;
+    case Hint::Random:     advice = MADV_RANDOM; break;
+    }
+    madvise(mapped, _size, advice); // only a hint, failure is fine
+}
+
+void MappedFile::unmap() noexcept {
+    if (_data) munmap(const_cast<std::byte*>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _path(std::move(other._path)),
+      _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0))
+#if defined(_WIN32)
+    , _file(std::exchange(other._file, nullptr)),
+      _mapping(std::exchange(other._mapping, nullptr))
+#endif
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        _path = std::move(other._path);
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#if defined(_WIN32)
+        _file = std::exchange(other._file, nullptr);
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+std::span<const std::byte> MappedFile::data() const {
+    return { _data, _size };
+}
+
+std::string_view MappedFile::view() const {
+    return { reinterpret_cast<const char*>(_data), _size };
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+const std::string& MappedFile::path() const {
+    return _path;
+}
+
+}
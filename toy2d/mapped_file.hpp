@@ -0,0 +1,53 @@
+/**
+  * @file   mapped_file.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace toy2d {
+
+// a read-only view of a whole file, paged in by the OS instead of copied into a buffer
+class MappedFile {
+public:
+    // how the contents will be read, forwarded to madvise / PrefetchVirtualMemory
+    enum class Hint {
+        Sequential, // read once front to back, e.g. image decoding
+        WillNeed,   // read soon and entirely, e.g. SPIR-V handed to the driver
+        Random,     // sparse reads, e.g. an archive index lookup
+    };
+
+private:
+    std::string _path;
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+#if defined(_WIN32)
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(std::string path, Hint hint = Hint::Sequential);
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::span<const std::byte> data() const;
+    std::string_view view() const;
+    size_t size() const;
+    const std::string& path() const;
+
+private:
+    void unmap() noexcept;
+};
+
+}
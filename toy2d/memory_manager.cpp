@@ -0,0 +1,331 @@
+/**
+  * @file   memory_manager.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "memory_manager.hpp"
+
+#include "context.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <tuple>
+
+namespace toy2d {
+
+std::string_view ToString(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::Vertex: return "vertex";
+    case MemoryCategory::Index: return "index";
+    case MemoryCategory::Uniform: return "uniform";
+    case MemoryCategory::Storage: return "storage";
+    case MemoryCategory::Staging: return "staging";
+    case MemoryCategory::Texture: return "texture";
+    case MemoryCategory::Attachment: return "attachment";
+    case MemoryCategory::Other: return "other";
+    }
+    return "unknown";
+}
+
+double MemoryStats::Usage::getFragmentation() const {
+    return bytes == 0 ? 0.0 : 1.0 - static_cast<double>(usedBytes) / static_cast<double>(bytes);
+}
+
+namespace {
+
+void WriteUsage(std::ostream& os, const MemoryStats::Usage& usage) {
+    os << "\"bytes\": " << usage.bytes
+       << ", \"usedBytes\": " << usage.usedBytes
+       << ", \"peakBytes\": " << usage.peakBytes
+       << ", \"allocations\": " << usage.allocationCount
+       << ", \"fragmentation\": " << usage.getFragmentation();
+}
+
+}
+
+void MemoryStats::WriteJson(std::ostream& os) const {
+    os << "{\n  \"heaps\": [";
+    for (size_t i = 0; i < heaps.size(); ++i) {
+        const auto& heap = heaps[i];
+        os << (i ? "," : "") << "\n    { \"index\": " << i
+           << ", \"size\": " << heap.size
+           << ", \"deviceLocal\": " << (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal ? "true" : "false")
+           << ", \"budget\": " << heap.budget;
+        if (heap.driverBudget) os << ", \"driverBudget\": " << *heap.driverBudget;
+        if (heap.driverUsage) os << ", \"driverUsage\": " << *heap.driverUsage;
+        os << ", ";
+        WriteUsage(os, heap.usage);
+        os << " }";
+    }
+    os << "\n  ],\n  \"types\": [";
+    for (size_t i = 0; i < types.size(); ++i) {
+        const auto& type = types[i];
+        os << (i ? "," : "") << "\n    { \"index\": " << i
+           << ", \"heap\": " << type.heap
+           << ", \"flags\": \"" << vk::to_string(type.flags) << "\", ";
+        WriteUsage(os, type.usage);
+        os << " }";
+    }
+    os << "\n  ],\n  \"categories\": {";
+    for (size_t i = 0; i < categories.size(); ++i) {
+        os << (i ? "," : "") << "\n    \"" << ToString(static_cast<MemoryCategory>(i)) << "\": { ";
+        WriteUsage(os, categories[i]);
+        os << " }";
+    }
+    os << "\n  },\n  \"totalAllocations\": " << totalAllocations
+       << ",\n  \"totalFrees\": " << totalFrees << "\n}\n";
+}
+
+void MemoryStats::Report(std::ostream& os) const {
+    auto mib = [](vk::DeviceSize bytes) { return static_cast<double>(bytes) / (1 << 20); };
+    for (size_t i = 0; i < heaps.size(); ++i) {
+        const auto& heap = heaps[i];
+        os << "  heap " << i << ": " << mib(heap.usage.bytes) << " MiB in " << heap.usage.allocationCount
+           << " allocations, budget " << mib(heap.budget) << " MiB";
+        if (heap.driverUsage) os << ", driver reports " << mib(*heap.driverUsage) << " MiB used";
+        os << std::endl;
+    }
+    for (size_t i = 0; i < categories.size(); ++i) {
+        const auto& usage = categories[i];
+        if (usage.allocationCount == 0) continue;
+        os << "  " << ToString(static_cast<MemoryCategory>(i)) << ": " << mib(usage.bytes) << " MiB in "
+           << usage.allocationCount << " allocations, " << usage.getFragmentation() * 100 << "% unused" << std::endl;
+    }
+}
+
+MemoryRequest MemoryRequest::DeviceOnly() {
+    // keeps the small BAR window of discrete GPUs free for what the host writes
+    return {
+        .required = vk::MemoryPropertyFlagBits::eDeviceLocal,
+        .undesired = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached,
+    };
+}
+
+MemoryRequest MemoryRequest::Upload() {
+    // write-combined system memory, no reason to spend device local memory on staging
+    return {
+        .required = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .undesired = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostCached,
+    };
+}
+
+MemoryRequest MemoryRequest::Readback() {
+    // uncached reads from write-combined memory are what makes readbacks slow
+    return {
+        .required = vk::MemoryPropertyFlagBits::eHostVisible,
+        .preferred = vk::MemoryPropertyFlagBits::eHostCached | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .undesired = vk::MemoryPropertyFlagBits::eDeviceLocal,
+    };
+}
+
+MemoryRequest MemoryRequest::Unified() {
+    return {
+        .required = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent,
+        .undesired = vk::MemoryPropertyFlagBits::eHostCached,
+    };
+}
+
+MemoryRequest MemoryRequest::FromFlags(vk::MemoryPropertyFlags required) {
+    MemoryRequest request;
+    if (!(required & vk::MemoryPropertyFlagBits::eHostVisible)) request = DeviceOnly();
+    else if (required & vk::MemoryPropertyFlagBits::eDeviceLocal) request = Unified();
+    else if (required & vk::MemoryPropertyFlagBits::eHostCached) request = Readback();
+    else request = Upload();
+    // exactly what was asked for is required, the preset only ranks the types having it
+    request.required = required;
+    request.preferred &= ~required;
+    request.undesired &= ~required;
+    return request;
+}
+
+MemoryManager::MemoryManager() {
+    _properties = Context::GetInstance().phyDevice.getMemoryProperties();
+    RefreshBudget();
+}
+
+MemoryManager::~MemoryManager() {
+    if (_allocations.empty()) return;
+    std::clog << "Memory manager destroyed with " << _allocations.size() << " allocations alive:" << std::endl;
+    getStats().Report(std::clog);
+}
+
+int MemoryManager::score(vk::MemoryPropertyFlags flags, const MemoryRequest& request) {
+    auto bits = [](vk::MemoryPropertyFlags flags) { return std::popcount(static_cast<VkMemoryPropertyFlags>(flags)); };
+    return bits(flags & request.preferred) - bits(flags & request.undesired);
+}
+
+std::vector<uint32_t> MemoryManager::RankMemoryTypes(uint32_t typeBits, std::span<const MemoryRequest> chain, vk::DeviceSize size) const {
+    // (over budget, chain position, -score, type index)
+    std::vector<std::tuple<bool, size_t, int, uint32_t>> candidates;
+    for (size_t position = 0; position < chain.size(); ++position) {
+        const auto& request = chain[position];
+        for (uint32_t i = 0; i < _properties.memoryTypeCount; ++i) {
+            auto flags = _properties.memoryTypes[i].propertyFlags;
+            if (!(typeBits & (1u << i)) || (flags & request.required) != request.required) continue;
+            // protected memory needs protected submits, lazily allocated memory only suits transient attachments
+            auto special = vk::MemoryPropertyFlagBits::eProtected | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+            if ((flags & special) & ~request.required) continue;
+
+            auto heap = _properties.memoryTypes[i].heapIndex;
+            bool overBudget = heapUsage(heap) + size > heapBudget(heap);
+            candidates.emplace_back(overBudget, position, -score(flags, request), i);
+        }
+    }
+    std::ranges::sort(candidates);
+
+    std::vector<uint32_t> ranked;
+    for (const auto& [overBudget, position, negativeScore, index] : candidates) {
+        if (std::ranges::find(ranked, index) == ranked.end()) ranked.push_back(index);
+    }
+    return ranked;
+}
+
+vk::DeviceMemory MemoryManager::Allocate(const vk::MemoryRequirements& requirements, std::span<const MemoryRequest> chain,
+                                         MemoryCategory category, vk::DeviceSize usedSize, const void* next) {
+    auto ranked = RankMemoryTypes(requirements.memoryTypeBits, chain, requirements.size);
+    if (ranked.empty()) {
+        throw std::runtime_error("Failed to find suitable memory type.");
+    }
+
+    auto& device = Context::GetInstance().device;
+    for (auto index : ranked) {
+        vk::MemoryAllocateInfo allocInfo;
+        allocInfo
+        .setAllocationSize(requirements.size)
+        .setMemoryTypeIndex(index)
+        .setPNext(next);
+
+        vk::DeviceMemory memory;
+        try {
+            memory = device.allocateMemory(allocInfo);
+        } catch (const vk::OutOfDeviceMemoryError&) {
+            continue; // the heap is full after all, the next type may live on another one
+        } catch (const vk::OutOfHostMemoryError&) {
+            continue; // host-visible types are backed by system memory on some drivers, a device-local one may still fit
+        }
+
+        Allocation allocation { index, category, requirements.size, usedSize == 0 ? requirements.size : std::min(usedSize, requirements.size) };
+        for (auto usage : { &_heapUsage[_properties.memoryTypes[index].heapIndex], &_typeUsage[index],
+                            &_categoryUsage[static_cast<size_t>(category)] }) {
+            usage->bytes += allocation.size;
+            usage->usedBytes += allocation.usedSize;
+            usage->peakBytes = std::max(usage->peakBytes, usage->bytes);
+            ++usage->allocationCount;
+        }
+        ++_totalAllocations;
+        _allocations[memory] = allocation;
+        return memory;
+    }
+    throw std::runtime_error("Out of memory in every suitable memory type.");
+}
+
+void MemoryManager::Free(vk::DeviceMemory memory) {
+    if (!memory) return;
+    if (auto it = _allocations.find(memory); it != _allocations.end()) {
+        const auto& allocation = it->second;
+        for (auto usage : { &_heapUsage[_properties.memoryTypes[allocation.typeIndex].heapIndex], &_typeUsage[allocation.typeIndex],
+                            &_categoryUsage[static_cast<size_t>(allocation.category)] }) {
+            usage->bytes -= allocation.size;
+            usage->usedBytes -= allocation.usedSize;
+            --usage->allocationCount;
+        }
+        ++_totalFrees;
+        _allocations.erase(it);
+    }
+    Context::GetInstance().device.freeMemory(memory);
+}
+
+void MemoryManager::RefreshBudget() {
+    auto& ctx = Context::GetInstance();
+    if (!ctx.features.memoryBudget) return;
+
+    auto chain = ctx.phyDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+    const auto& budget = chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+
+    _hasDriverBudget = true;
+    for (uint32_t i = 0; i < _properties.memoryHeapCount; ++i) {
+        _driverBudget[i] = budget.heapBudget[i];
+        _driverUsage[i] = budget.heapUsage[i];
+        // allocations made until the next refresh are counted by this manager only
+        _externalUsage[i] = budget.heapUsage[i] > _heapUsage[i].bytes ? budget.heapUsage[i] - _heapUsage[i].bytes : 0;
+    }
+}
+
+MemoryStats MemoryManager::getStats() const {
+    MemoryStats stats;
+    for (uint32_t i = 0; i < _properties.memoryHeapCount; ++i) {
+        MemoryStats::Heap heap {
+            .size = _properties.memoryHeaps[i].size,
+            .flags = _properties.memoryHeaps[i].flags,
+            .budget = heapBudget(i),
+            .usage = _heapUsage[i],
+        };
+        if (_hasDriverBudget) {
+            heap.driverBudget = _driverBudget[i];
+            heap.driverUsage = _driverUsage[i];
+        }
+        stats.heaps.push_back(heap);
+    }
+    for (uint32_t i = 0; i < _properties.memoryTypeCount; ++i) {
+        stats.types.push_back({ _properties.memoryTypes[i].heapIndex, _properties.memoryTypes[i].propertyFlags, _typeUsage[i] });
+    }
+    stats.categories = _categoryUsage;
+    stats.totalAllocations = _totalAllocations;
+    stats.totalFrees = _totalFrees;
+    return stats;
+}
+
+vk::MemoryPropertyFlags MemoryManager::getMemoryProperty(vk::DeviceMemory memory) const {
+    auto it = _allocations.find(memory);
+    if (it == _allocations.end()) {
+        throw std::runtime_error("Memory was not allocated by the memory manager.");
+    }
+    return _properties.memoryTypes[it->second.typeIndex].propertyFlags;
+}
+
+vk::DeviceSize MemoryManager::getHeapBudget(uint32_t heap) const {
+    return heapBudget(heap);
+}
+
+vk::DeviceSize MemoryManager::getHeapUsage(uint32_t heap) const {
+    return heapUsage(heap);
+}
+
+vk::DeviceSize MemoryManager::heapBudget(uint32_t heap) const {
+    auto budget = _hasDriverBudget ? _driverBudget[heap] : _properties.memoryHeaps[heap].size;
+    return budget / 100 * budgetPercent;
+}
+
+vk::DeviceSize MemoryManager::heapUsage(uint32_t heap) const {
+    return _externalUsage[heap] + _heapUsage[heap].bytes;
+}
+
+const vk::PhysicalDeviceMemoryProperties& MemoryManager::getProperties() const {
+    return _properties;
+}
+
+bool MemoryManager::HasUnifiedMemory() const {
+    // integrated GPUs have one heap, resizable BAR maps all of VRAM.
+    // the 256 MiB BAR window of other discrete GPUs is too small to put every buffer in
+    vk::DeviceSize largestDeviceHeap = 0;
+    for (uint32_t i = 0; i < _properties.memoryHeapCount; ++i) {
+        if (_properties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            largestDeviceHeap = std::max(largestDeviceHeap, _properties.memoryHeaps[i].size);
+        }
+    }
+    auto unified = MemoryRequest::Unified().required;
+    for (uint32_t i = 0; i < _properties.memoryTypeCount; ++i) {
+        const auto& memoryType = _properties.memoryTypes[i];
+        if ((memoryType.propertyFlags & unified) == unified &&
+            _properties.memoryHeaps[memoryType.heapIndex].size == largestDeviceHeap) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,143 @@
+/**
+  * @file   memory_manager.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <array>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace toy2d {
+
+// what an allocation needs from its memory type. types missing a required flag are never picked,
+// the others are ranked by preferred (+1 each) and undesired (-1 each) flags
+struct MemoryRequest {
+    vk::MemoryPropertyFlags required;
+    vk::MemoryPropertyFlags preferred;
+    vk::MemoryPropertyFlags undesired;
+
+    static MemoryRequest DeviceOnly(); // only the GPU touches it, host visible types are left to uploads
+    static MemoryRequest Upload();     // written once by the host, read by transfers
+    static MemoryRequest Readback();   // written by the GPU, read by the host
+    static MemoryRequest Unified();    // device local and written by the host in place
+    static MemoryRequest FromFlags(vk::MemoryPropertyFlags required); // the closest of the above
+};
+
+// what an allocation is for, statistics are kept per category
+enum class MemoryCategory {
+    Vertex,
+    Index,
+    Uniform,
+    Storage,    // storage buffers and buffers read through device addresses
+    Staging,
+    Texture,
+    Attachment, // render graph transients
+    Other,
+};
+
+constexpr size_t memoryCategoryCount = static_cast<size_t>(MemoryCategory::Other) + 1;
+std::string_view ToString(MemoryCategory category);
+
+// a snapshot of MemoryManager's accounting
+struct MemoryStats {
+    struct Usage {
+        vk::DeviceSize bytes = 0;     // allocated
+        vk::DeviceSize usedBytes = 0; // asked for by the resources, the rest is alignment padding and unused capacity
+        vk::DeviceSize peakBytes = 0;
+        uint64_t allocationCount = 0; // live
+
+        double getFragmentation() const; // share of the allocated bytes no resource uses
+    };
+
+    struct Heap {
+        vk::DeviceSize size;
+        vk::MemoryHeapFlags flags;
+        vk::DeviceSize budget;                     // what toy2d allows itself to use, see MemoryManager::budgetPercent
+        std::optional<vk::DeviceSize> driverBudget; // VK_EXT_memory_budget, for this process
+        std::optional<vk::DeviceSize> driverUsage;  // VK_EXT_memory_budget, including what toy2d did not allocate itself
+        Usage usage;
+    };
+
+    struct Type {
+        uint32_t heap;
+        vk::MemoryPropertyFlags flags;
+        Usage usage;
+    };
+
+    std::vector<Heap> heaps;
+    std::vector<Type> types;
+    std::array<Usage, memoryCategoryCount> categories;
+    uint64_t totalAllocations = 0; // since start, drifting away from totalFrees in a steady scene means a leak
+    uint64_t totalFrees = 0;
+
+    void WriteJson(std::ostream& os) const;
+    void Report(std::ostream& os) const; // one line per heap and category
+};
+
+// picks memory types and allocates device memory, keeping track of how much of each heap is in use.
+// not thread-safe, device memory is only allocated and freed on the render thread
+class MemoryManager {
+public:
+    static constexpr vk::DeviceSize budgetPercent = 80; // of a heap (or the driver's budget), the rest is left to the driver and other processes
+
+private:
+    struct Allocation {
+        uint32_t typeIndex;
+        MemoryCategory category;
+        vk::DeviceSize size;
+        vk::DeviceSize usedSize;
+    };
+
+    vk::PhysicalDeviceMemoryProperties _properties;
+    std::unordered_map<VkDeviceMemory, Allocation> _allocations;
+    std::array<MemoryStats::Usage, VK_MAX_MEMORY_HEAPS> _heapUsage {};
+    std::array<MemoryStats::Usage, VK_MAX_MEMORY_TYPES> _typeUsage {};
+    std::array<MemoryStats::Usage, memoryCategoryCount> _categoryUsage {};
+    uint64_t _totalAllocations = 0;
+    uint64_t _totalFrees = 0;
+
+    // VK_EXT_memory_budget, as of the last RefreshBudget()
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> _driverBudget {};
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> _driverUsage {};
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> _externalUsage {}; // driver usage not allocated through this manager
+    bool _hasDriverBudget = false;
+
+public:
+    MemoryManager();
+    MemoryManager(const MemoryManager&) = delete;
+    ~MemoryManager(); // reports allocations still alive
+
+    // candidate types best first: within budget before over budget, then by position in the chain, then by score
+    std::vector<uint32_t> RankMemoryTypes(uint32_t typeBits, std::span<const MemoryRequest> chain, vk::DeviceSize size) const;
+    // tries the ranked types in order until one allocation succeeds. usedSize is what the resource needs of it, 0 for all
+    vk::DeviceMemory Allocate(const vk::MemoryRequirements& requirements, std::span<const MemoryRequest> chain,
+                              MemoryCategory category, vk::DeviceSize usedSize = 0, const void* next = nullptr);
+    void Free(vk::DeviceMemory memory);
+
+    void RefreshBudget(); // once per frame, the driver's numbers change with every allocation anywhere on the system
+    MemoryStats getStats() const;
+
+    vk::MemoryPropertyFlags getMemoryProperty(vk::DeviceMemory memory) const;
+    vk::DeviceSize getHeapBudget(uint32_t heap) const;
+    vk::DeviceSize getHeapUsage(uint32_t heap) const; // toy2d's own allocations plus, with the budget extension, everything else
+    const vk::PhysicalDeviceMemoryProperties& getProperties() const;
+    bool HasUnifiedMemory() const; // the host can write all of device local memory directly
+
+private:
+    static int score(vk::MemoryPropertyFlags flags, const MemoryRequest& request);
+    vk::DeviceSize heapBudget(uint32_t heap) const;
+    vk::DeviceSize heapUsage(uint32_t heap) const;
+};
+
+}
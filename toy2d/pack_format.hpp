@@ -0,0 +1,65 @@
+/**
+  * @file   pack_format.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include <bit>
+#include <string_view>
+#include <cstdint>
+
+namespace toy2d::pack {
+
+// on-disk layout of a .pack archive, shared by AssetPack and the toy2d_pack builder:
+//   Header | blobs, each aligned to header.alignment | Entry[entryCount] sorted by (hash, name) | names
+// all integers are little endian, offsets are from the start of the file
+
+static_assert(std::endian::native == std::endian::little, "pack files are read in place and store little endian integers");
+
+inline constexpr char magic[4] = { 'T', '2', 'D', 'P' };
+inline constexpr uint32_t version = 1;
+inline constexpr uint32_t defaultAlignment = 16; // SPIR-V needs 4, vertex data is happy with 16
+
+enum class Compression : uint32_t {
+    None = 0,
+    Zstd = 1,
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t indexOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct Entry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;       // after decompression
+    uint64_t storedSize; // bytes in the file
+    uint32_t nameOffset; // relative to header.namesOffset
+    uint32_t nameLength;
+    Compression compression;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(Entry) == 48);
+
+// FNV-1a, names are relative paths with '/' separators, e.g. "shader/texture.frag.spv"
+constexpr uint64_t Hash(std::string_view name) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+}
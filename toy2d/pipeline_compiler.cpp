@@ -0,0 +1,53 @@
+/**
+  * @file   pipeline_compiler.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "pipeline_compiler.hpp"
+
+#include <algorithm>
+
+namespace toy2d {
+
+PipelineCompiler::PipelineCompiler(uint32_t threadCount) {
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        _workers.emplace_back([this](std::stop_token stop) { work(stop); });
+    }
+}
+
+PipelineCompiler::~PipelineCompiler() {
+    // queued jobs are dropped, running ones finish
+    for (auto& worker : _workers) worker.request_stop();
+    _wake.notify_all();
+    _workers.clear();
+}
+
+uint32_t PipelineCompiler::DefaultThreadCount() {
+    // leave the rest of the cores to the render thread and the driver
+    return std::max(1u, std::thread::hardware_concurrency() / 2);
+}
+
+void PipelineCompiler::Enqueue(std::function<void()> job) {
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _wake.notify_one();
+}
+
+void PipelineCompiler::work(std::stop_token stop) {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(_mutex);
+            if (!_wake.wait(lock, stop, [this] { return !_jobs.empty(); })) return; // stop requested
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+}
@@ -0,0 +1,40 @@
+/**
+  * @file   pipeline_compiler.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace toy2d {
+
+// worker threads for pipeline creation, vkCreateGraphicsPipelines is thread-safe with a shared cache
+class PipelineCompiler {
+private:
+    std::mutex _mutex;
+    std::condition_variable_any _wake;
+    std::deque<std::function<void()>> _jobs;
+    std::vector<std::jthread> _workers; // declared last, joined before the queue goes away
+
+public:
+    PipelineCompiler(uint32_t threadCount = DefaultThreadCount());
+    ~PipelineCompiler();
+
+    void Enqueue(std::function<void()> job);
+
+    static uint32_t DefaultThreadCount();
+
+private:
+    void work(std::stop_token stop);
+};
+
+}
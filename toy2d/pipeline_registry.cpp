@@ -0,0 +1,309 @@
+/**
+  * @file   pipeline_registry.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "pipeline_registry.hpp"
+
+#include "context.hpp"
+#include "shader.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <iostream>
+
+namespace toy2d {
+
+PipelineRegistry::PipelineRegistry() {
+    _compiler.reset(new PipelineCompiler);
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    _compiler.reset(); // wait for running jobs, they write into _pipelines
+
+    auto& device = Context::GetInstance().device;
+    for (auto& entry : _pipelines) device.destroyPipeline(entry.pipeline);
+    _programs.clear();
+}
+
+size_t PipelineRegistry::KeyHash::operator()(const PipelineKey& key) const {
+    size_t seed = 0;
+    HashCombine(seed, key.program);
+    for (const auto& binding : key.vertexLayout.bindings) {
+        HashCombine(seed, binding.binding);
+        HashCombine(seed, binding.stride);
+        HashCombine(seed, binding.inputRate);
+    }
+    for (const auto& attribute : key.vertexLayout.attributes) {
+        HashCombine(seed, attribute.location);
+        HashCombine(seed, attribute.binding);
+        HashCombine(seed, attribute.format);
+        HashCombine(seed, attribute.offset);
+    }
+    HashCombine(seed, key.blend);
+    HashCombine(seed, key.topology);
+    HashCombine(seed, key.colorFormat);
+    return seed;
+}
+
+ProgramHandle PipelineRegistry::RegisterProgram(std::string name, std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode) {
+    auto shader = Shader::Load(vertexCode, fragmentCode);
+    std::lock_guard lock(_mutex);
+    _programs.push_back({ std::move(name), std::move(shader), 0 });
+    return static_cast<ProgramHandle>(_programs.size() - 1);
+}
+
+ProgramHandle PipelineRegistry::FindProgram(std::string_view name) {
+    std::lock_guard lock(_mutex);
+    auto it = std::ranges::find(_programs, name, &Program::name);
+    if (it == _programs.end()) {
+        throw std::runtime_error("Shader program '" + std::string(name) + "' is not registered.");
+    }
+    return static_cast<ProgramHandle>(it - _programs.begin());
+}
+
+PipelineHandle PipelineRegistry::Request(const PipelineDesc& desc) {
+    auto& shader = getShader(desc.program);
+
+    // fill in defaults first, so explicit and implicit descriptions of the same state share a pipeline
+    PipelineKey key;
+    key.program = desc.program;
+    key.vertexLayout = desc.vertexLayout.value_or(VertexLayout { shader.getVertexBindings(), shader.getVertexAttributes() });
+    for (const auto& input : shader.getVertexAttributes()) {
+        // packed formats are fine, the shader sees them as floats, but every input needs a source
+        if (std::ranges::none_of(key.vertexLayout.attributes, [&](const auto& attribute) { return attribute.location == input.location; })) {
+            throw std::runtime_error("Vertex layout has no attribute for shader input location " + std::to_string(input.location) + ".");
+        }
+    }
+    key.blend = desc.blend;
+    key.topology = desc.topology;
+    key.colorFormat = desc.colorFormat != vk::Format::eUndefined ? desc.colorFormat : Context::GetInstance().swapchain->info.format.format;
+
+    std::lock_guard lock(_mutex);
+    if (auto it = _handles.find(key); it != _handles.end()) return it->second;
+
+    auto handle = static_cast<PipelineHandle>(_pipelines.size());
+    _pipelines.emplace_back().key = key;
+    _handles.emplace(std::move(key), handle);
+    return handle;
+}
+
+vk::Pipeline PipelineRegistry::Get(PipelineHandle handle) {
+    auto& entry = entryOf(handle);
+    if (entry.state.load(std::memory_order_acquire) == State::Ready) return entry.pipeline;
+
+    // already on the compiler, waiting is cheaper than building it twice
+    std::unique_lock lock(_mutex);
+    _compiled.wait(lock, [&] { return entry.state.load() != State::Compiling; });
+    if (entry.state.load() == State::Ready) return entry.pipeline;
+
+    // created on the calling thread, workers only need the lock to publish their results
+    auto& program = _programs.at(entry.key.program);
+    auto shader = program.shader;
+    auto generation = program.generation;
+    lock.unlock();
+    auto pipeline = CreatePipeline(*shader, entry.key);
+    lock.lock();
+    entry.pipeline = pipeline;
+    entry.generation = generation;
+    entry.state.store(State::Ready, std::memory_order_release);
+    return pipeline;
+}
+
+void PipelineRegistry::CompileAsync(PipelineHandle handle) {
+    std::lock_guard lock(_mutex);
+    auto& entry = _pipelines.at(handle);
+    auto& program = _programs.at(entry.key.program);
+
+    // a failure is final for its generation, the program has to be reloaded before it is tried again
+    if (entry.state.load() == State::Failed && entry.generation != program.generation) entry.state.store(State::Missing);
+    if (entry.state.load() != State::Missing) return;
+    entry.state.store(State::Compiling);
+    entry.generation = program.generation;
+
+    _compiler->Enqueue([this, &entry, handle, name = program.name, shader = program.shader, generation = program.generation] {
+        vk::Pipeline pipeline;
+        try {
+            pipeline = CreatePipeline(*shader, entry.key);
+        } catch (const std::exception& e) {
+            std::cerr << std::format("Pipeline {} of program '{}' failed to compile, skipped until the program is reloaded: {}",
+                                     handle, name, e.what()) << std::endl;
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            if (_programs.at(entry.key.program).generation != generation) {
+                // the program was reloaded meanwhile, this pipeline uses the old modules
+                Context::GetInstance().device.destroyPipeline(pipeline);
+            } else {
+                entry.pipeline = pipeline;
+                entry.state.store(pipeline ? State::Ready : State::Failed, std::memory_order_release);
+            }
+        }
+        _compiled.notify_all();
+    });
+}
+
+bool PipelineRegistry::IsReady(PipelineHandle handle) {
+    return entryOf(handle).state.load(std::memory_order_acquire) == State::Ready;
+}
+
+vk::Pipeline PipelineRegistry::TryGet(PipelineHandle handle) {
+    auto& entry = entryOf(handle);
+    if (entry.state.load(std::memory_order_acquire) == State::Ready) return entry.pipeline;
+    CompileAsync(handle);
+    return nullptr;
+}
+
+Shader& PipelineRegistry::getShader(ProgramHandle program) {
+    // the shader is only swapped by ReplaceProgram, while the device is idle and the reloader is locked out
+    std::lock_guard lock(_mutex);
+    return *_programs.at(program).shader;
+}
+
+ProgramHandle PipelineRegistry::getProgram(PipelineHandle handle) {
+    return entryOf(handle).key.program;
+}
+
+vk::PipelineLayout PipelineRegistry::getLayout(PipelineHandle handle) {
+    return getShader(getProgram(handle)).getPipelineLayout();
+}
+
+std::vector<std::pair<PipelineHandle, PipelineRegistry::PipelineKey>> PipelineRegistry::getPipelines(ProgramHandle program) {
+    std::lock_guard lock(_mutex);
+    std::vector<std::pair<PipelineHandle, PipelineKey>> pipelines;
+    for (size_t i = 0; i < _pipelines.size(); ++i) {
+        // failed and not yet created pipelines are left to be built on next use
+        if (_pipelines[i].key.program != program || _pipelines[i].state.load() != State::Ready) continue;
+        pipelines.emplace_back(static_cast<PipelineHandle>(i), _pipelines[i].key);
+    }
+    return pipelines;
+}
+
+void PipelineRegistry::ReplaceProgram(ProgramHandle program, std::unique_ptr<Shader> shader,
+                                      const std::vector<std::pair<PipelineHandle, vk::Pipeline>>& pipelines) {
+    auto& device = Context::GetInstance().device;
+    {
+        std::lock_guard lock(_mutex);
+        for (auto& entry : _pipelines) {
+            if (entry.key.program != program) continue;
+            device.destroyPipeline(entry.pipeline);
+            entry.pipeline = nullptr;
+            entry.state.store(State::Missing); // failed ones included, they get another try with the new modules
+        }
+        for (const auto& [handle, pipeline] : pipelines) {
+            auto& entry = _pipelines.at(handle);
+            entry.pipeline = pipeline;
+            entry.state.store(State::Ready);
+        }
+        _programs.at(program).shader = std::move(shader);
+        ++_programs.at(program).generation;
+    }
+    _compiled.notify_all(); // in-flight jobs of the old generation no longer count
+}
+
+PipelineRegistry::Entry& PipelineRegistry::entryOf(PipelineHandle handle) {
+    std::lock_guard lock(_mutex);
+    return _pipelines.at(handle);
+}
+
+vk::Pipeline PipelineRegistry::CreatePipeline(Shader& shader, const PipelineKey& key) {
+    auto& ctx = Context::GetInstance();
+    auto& renderProcess = ctx.renderProcess;
+    if (!renderProcess->dynamicRendering && key.colorFormat != ctx.swapchain->info.format.format) {
+        throw std::runtime_error("No render pass for the requested color format.");
+    }
+
+    vk::GraphicsPipelineCreateInfo createInfo;
+
+    // 1. Vertex Input
+    vk::PipelineVertexInputStateCreateInfo inputState;
+    inputState
+    .setVertexAttributeDescriptions(key.vertexLayout.attributes)
+    .setVertexBindingDescriptions(key.vertexLayout.bindings);
+    createInfo.setPVertexInputState(&inputState);
+
+    // 2. Vertex Assembly
+    vk::PipelineInputAssemblyStateCreateInfo asmState;
+    asmState
+    .setPrimitiveRestartEnable(false) // disable primitive restart
+    .setTopology(key.topology);
+    createInfo.setPInputAssemblyState(&asmState);
+
+    // 3. Shader
+    auto stages = shader.getStages();
+    createInfo.setStages(stages);
+
+    // 4. Viewport State (set when the render pass begins, so pipelines do not depend on the window size)
+    vk::PipelineViewportStateCreateInfo viewportState;
+    viewportState
+    .setViewportCount(1)
+    .setScissorCount(1);
+    createInfo.setPViewportState(&viewportState);
+
+    std::array<vk::DynamicState, 2> dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+    vk::PipelineDynamicStateCreateInfo dynamicState;
+    dynamicState.setDynamicStates(dynamicStates);
+    createInfo.setPDynamicState(&dynamicState);
+
+    // 5. Rasterization
+    vk::PipelineRasterizationStateCreateInfo rasterState;
+    rasterState
+    .setRasterizerDiscardEnable(false) // if true then no output to framebuffer
+    .setCullMode(vk::CullModeFlagBits::eBack)
+    .setFrontFace(vk::FrontFace::eClockwise)
+    .setPolygonMode(vk::PolygonMode::eFill)
+    .setLineWidth(1); // no depth settings needed for 2D
+    createInfo.setPRasterizationState(&rasterState);
+
+    // 6. Multisample
+    vk::PipelineMultisampleStateCreateInfo multisample;
+    multisample
+    .setSampleShadingEnable(false) // disable multisampling
+    .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    createInfo.setPMultisampleState(&multisample);
+
+    // 7. Test (No need for 2D)
+
+    // 8. Color Blending
+    // NewAlpha = 1 * SrcAlpha + 0 * DstAlpha
+    vk::PipelineColorBlendStateCreateInfo blend;
+    vk::PipelineColorBlendAttachmentState attach;
+    attach
+    .setBlendEnable(key.blend != BlendMode::Opaque)
+    .setColorWriteMask(vk::ColorComponentFlagBits::eA | vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB)
+    .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
+    .setDstColorBlendFactor(key.blend == BlendMode::Additive ? vk::BlendFactor::eOne : vk::BlendFactor::eOneMinusSrcAlpha)
+    .setColorBlendOp(vk::BlendOp::eAdd)
+    .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
+    .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
+    .setAlphaBlendOp(vk::BlendOp::eAdd);
+    blend
+    .setLogicOpEnable(false) // disable logic operations
+    .setAttachments(attach);
+    createInfo.setPColorBlendState(&blend);
+
+    // 9. Layout
+    createInfo.setLayout(shader.getPipelineLayout());
+
+    // 10. Render Pass (or just the attachment formats with dynamic rendering)
+    vk::PipelineRenderingCreateInfo renderingInfo;
+    if (renderProcess->dynamicRendering) {
+        renderingInfo.setColorAttachmentFormats(key.colorFormat);
+        createInfo.setPNext(&renderingInfo);
+    } else {
+        createInfo.setRenderPass(renderProcess->renderPass);
+    }
+
+    auto result = ctx.device.createGraphicsPipeline(ctx.pipelineCache, createInfo);
+    if (result.result != vk::Result::eSuccess) {
+        throw std::runtime_error("Failed to create graphics pipeline.");
+    }
+    return result.value;
+}
+
+}
@@ -0,0 +1,130 @@
+/**
+  * @file   pipeline_registry.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "pipeline_compiler.hpp"
+#include "vertex.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace toy2d {
+
+class Shader;
+
+using ProgramHandle = uint32_t;
+using PipelineHandle = uint32_t;
+
+enum class BlendMode {
+    Opaque,   // NewColor = SrcColor
+    Alpha,    // NewColor = SrcAlpha * SrcColor + (1 - SrcAlpha) * DstColor
+    Additive, // NewColor = SrcAlpha * SrcColor + DstColor
+};
+
+struct PipelineDesc {
+    ProgramHandle program;
+    std::optional<VertexLayout> vertexLayout; // defaults to the layout reflected from the program, see MakeVertexLayout
+    BlendMode blend = BlendMode::Alpha;
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+    vk::Format colorFormat = vk::Format::eUndefined; // defaults to the swapchain format
+};
+
+// owns every shader program and creates one pipeline per distinct state combination, on first use
+class PipelineRegistry {
+public:
+    struct PipelineKey {
+        ProgramHandle program;
+        VertexLayout vertexLayout;
+        BlendMode blend;
+        vk::PrimitiveTopology topology;
+        vk::Format colorFormat;
+
+        bool operator==(const PipelineKey& other) const = default;
+    };
+
+private:
+    struct KeyHash {
+        size_t operator()(const PipelineKey& key) const;
+    };
+
+    enum class State {
+        Missing,   // not created yet, or dropped by a program reload
+        Compiling, // queued on the compiler
+        Ready,
+        Failed,    // background creation threw and was logged once, retried after a reload of the program or by Get()
+    };
+
+    struct Program {
+        std::string name;
+        std::shared_ptr<Shader> shader; // compile jobs keep the shader they were queued with alive
+        uint32_t generation = 0;        // bumped on reload, stale compile results are dropped
+    };
+
+    struct Entry {
+        PipelineKey key;
+        vk::Pipeline pipeline; // written under _mutex before state becomes Ready
+        std::atomic<State> state = State::Missing;
+        uint32_t generation = 0; // program generation the state belongs to
+    };
+
+    std::deque<Program> _programs; // indexed by ProgramHandle, stable while programs are registered
+    std::deque<Entry> _pipelines;  // indexed by PipelineHandle, stable for compile jobs
+    std::unordered_map<PipelineKey, PipelineHandle, KeyHash> _handles;
+    std::mutex _mutex; // compile jobs and the shader reloader run on worker threads
+    std::condition_variable _compiled;
+    std::unique_ptr<PipelineCompiler> _compiler;
+
+public:
+    PipelineRegistry();
+    ~PipelineRegistry();
+
+    ProgramHandle RegisterProgram(std::string name, std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode);
+    ProgramHandle FindProgram(std::string_view name);
+
+    // returns the same handle for equal state, the pipeline itself is created by Get() or CompileAsync()
+    PipelineHandle Request(const PipelineDesc& desc);
+    vk::Pipeline Get(PipelineHandle handle); // blocks until the pipeline exists
+
+    // non-blocking: queue on the compiler, TryGet returns null until the pipeline is ready
+    void CompileAsync(PipelineHandle handle);
+    bool IsReady(PipelineHandle handle);
+    vk::Pipeline TryGet(PipelineHandle handle);
+
+    Shader& getShader(ProgramHandle program);
+    ProgramHandle getProgram(PipelineHandle handle);
+    vk::PipelineLayout getLayout(PipelineHandle handle);
+    std::vector<std::pair<PipelineHandle, PipelineKey>> getPipelines(ProgramHandle program);
+
+    // thread-safe, does not touch the registry
+    static vk::Pipeline CreatePipeline(Shader& shader, const PipelineKey& key);
+
+    // takes over a rebuilt shader and its pipelines, the device must be idle
+    // pipelines of the program missing from `pipelines` are recreated on next use
+    void ReplaceProgram(ProgramHandle program, std::unique_ptr<Shader> shader,
+                        const std::vector<std::pair<PipelineHandle, vk::Pipeline>>& pipelines);
+
+private:
+    // looked up under _mutex, the returned entry stays valid while others are appended
+    Entry& entryOf(PipelineHandle handle);
+};
+
+}
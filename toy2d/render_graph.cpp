@@ -0,0 +1,422 @@
+/**
+  * @file   render_graph.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "render_graph.hpp"
+
+#include "context.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace toy2d {
+
+namespace {
+
+// color images only, every mip and layer
+const vk::ImageSubresourceRange colorRange(vk::ImageAspectFlagBits::eColor, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS);
+
+}
+
+RenderGraph::~RenderGraph() {
+    destroyTransients();
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(ResourceHandle resource, Access access) {
+    _graph._passes[_pass].reads.push_back({ resource, access });
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(ResourceHandle resource, Access access) {
+    _graph._passes[_pass].writes.push_back({ resource, access });
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::SideEffect() {
+    _graph._passes[_pass].sideEffect = true;
+    return *this;
+}
+
+RenderGraph::AccessInfo RenderGraph::getAccessInfo(Access access) {
+    // only bits that have the same value in the legacy flags, so PipelineBarrier can fall back without synchronization2
+    using Stage = vk::PipelineStageFlagBits2;
+    using AccessBit = vk::AccessFlagBits2;
+    using Layout = vk::ImageLayout;
+    switch (access) {
+    case Access::None:                 return { Stage::eNone, AccessBit::eNone, Layout::eUndefined, false };
+    case Access::SwapchainAcquire:     return { Stage::eColorAttachmentOutput, AccessBit::eNone, Layout::eUndefined, false };
+    case Access::ColorAttachmentWrite: return { Stage::eColorAttachmentOutput, AccessBit::eColorAttachmentWrite, Layout::eColorAttachmentOptimal, true };
+    case Access::ColorAttachmentRead:  return { Stage::eColorAttachmentOutput, AccessBit::eColorAttachmentRead, Layout::eColorAttachmentOptimal, false };
+    case Access::VertexShaderRead:     return { Stage::eVertexShader, AccessBit::eShaderRead, Layout::eShaderReadOnlyOptimal, false };
+    case Access::FragmentShaderRead:   return { Stage::eFragmentShader, AccessBit::eShaderRead, Layout::eShaderReadOnlyOptimal, false };
+    case Access::VertexBufferRead:     return { Stage::eVertexInput, AccessBit::eVertexAttributeRead, Layout::eUndefined, false };
+    case Access::IndexBufferRead:      return { Stage::eVertexInput, AccessBit::eIndexRead, Layout::eUndefined, false };
+    case Access::TransferRead:         return { Stage::eTransfer, AccessBit::eTransferRead, Layout::eTransferSrcOptimal, false };
+    case Access::TransferWrite:        return { Stage::eTransfer, AccessBit::eTransferWrite, Layout::eTransferDstOptimal, true };
+    case Access::HostWrite:            return { Stage::eHost, AccessBit::eHostWrite, Layout::eUndefined, true };
+    case Access::Present:              return { Stage::eNone, AccessBit::eNone, Layout::ePresentSrcKHR, false };
+    }
+    throw std::runtime_error("Unknown render graph access.");
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportImage(std::string name, vk::Image image, vk::ImageView view,
+                                                     Access initialAccess, std::optional<Access> finalAccess) {
+    Resource resource { .name = std::move(name), .isImage = true, .imported = true, .initialAccess = initialAccess, .finalAccess = finalAccess };
+    resource.image = image;
+    resource.view = view;
+    _resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(_resources.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportBuffer(std::string name, vk::Buffer buffer,
+                                                      Access initialAccess, std::optional<Access> finalAccess) {
+    Resource resource { .name = std::move(name), .isImage = false, .imported = true, .initialAccess = initialAccess, .finalAccess = finalAccess };
+    resource.buffer = buffer;
+    _resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(_resources.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::CreateImage(std::string name, const ImageDesc& desc) {
+    Resource resource { .name = std::move(name), .isImage = true, .imported = false };
+    resource.desc = desc;
+    _resources.push_back(std::move(resource));
+    return static_cast<ResourceHandle>(_resources.size() - 1);
+}
+
+void RenderGraph::AddPass(std::string name, const std::function<void(PassBuilder&)>& setup, ExecuteFunc execute) {
+    _passes.push_back({ .name = std::move(name), .execute = std::move(execute) });
+    PassBuilder builder(*this, _passes.size() - 1);
+    setup(builder);
+}
+
+void RenderGraph::Compile() {
+    cullPasses();
+    computeLifetimes();
+    allocateTransients();
+    computeBarriers();
+}
+
+void RenderGraph::Execute(vk::CommandBuffer& cmdBuf) {
+    for (auto& pass : _passes) {
+        if (pass.culled) continue;
+        if (!pass.imageBarriers.empty() || !pass.memoryBarriers.empty()) {
+            PipelineBarrier(cmdBuf, pass.imageBarriers, pass.memoryBarriers);
+        }
+        pass.execute(cmdBuf);
+    }
+    if (!_finalImageBarriers.empty() || !_finalMemoryBarriers.empty()) {
+        PipelineBarrier(cmdBuf, _finalImageBarriers, _finalMemoryBarriers);
+    }
+}
+
+void RenderGraph::Reset() {
+    _passes.clear();
+    _resources.clear();
+    _finalImageBarriers.clear();
+    _finalMemoryBarriers.clear();
+}
+
+void RenderGraph::cullPasses() {
+    // walk backwards from the outputs, a pass survives if something later needs what it writes
+    std::vector<bool> needed(_resources.size());
+    for (size_t i = 0; i < _resources.size(); ++i) needed[i] = _resources[i].imported;
+
+    for (auto pass = _passes.rbegin(); pass != _passes.rend(); ++pass) {
+        pass->culled = !pass->sideEffect && std::ranges::none_of(pass->writes, [&](const Use& use) { return needed[use.resource]; });
+        if (pass->culled) continue;
+        for (const auto& use : pass->reads) needed[use.resource] = true;
+    }
+}
+
+void RenderGraph::computeLifetimes() {
+    for (int i = 0; i < static_cast<int>(_passes.size()); ++i) {
+        const auto& pass = _passes[i];
+        if (pass.culled) continue;
+        for (const auto* uses : { &pass.reads, &pass.writes }) {
+            for (const auto& use : *uses) {
+                auto& resource = _resources[use.resource];
+                if (resource.firstPass < 0) resource.firstPass = i;
+                resource.lastPass = i;
+
+                // transient images get exactly the usage their passes need
+                switch (use.access) {
+                case Access::ColorAttachmentWrite:
+                case Access::ColorAttachmentRead:
+                    resource.usage |= vk::ImageUsageFlagBits::eColorAttachment; break;
+                case Access::VertexShaderRead:
+                case Access::FragmentShaderRead:
+                    resource.usage |= vk::ImageUsageFlagBits::eSampled; break;
+                case Access::TransferRead:
+                    resource.usage |= vk::ImageUsageFlagBits::eTransferSrc; break;
+                case Access::TransferWrite:
+                    resource.usage |= vk::ImageUsageFlagBits::eTransferDst; break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void RenderGraph::allocateTransients() {
+    // transient images in order of first use, unused ones get no memory at all
+    std::vector<ResourceHandle> transients;
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        const auto& resource = _resources[i];
+        if (resource.isImage && !resource.imported && resource.firstPass >= 0) transients.push_back(static_cast<ResourceHandle>(i));
+    }
+    std::ranges::stable_sort(transients, {}, [&](ResourceHandle handle) { return _resources[handle].firstPass; });
+
+    // interval colouring: an image reuses the memory of one whose lifetime already ended
+    std::vector<Allocation> plan;
+    std::vector<std::pair<int, ResourceHandle>> blockEnds; // last pass and last occupant of each block
+    for (auto handle : transients) {
+        auto& resource = _resources[handle];
+        auto block = std::ranges::find_if(blockEnds, [&](const auto& end) { return end.first < resource.firstPass; });
+        if (block == blockEnds.end()) {
+            blockEnds.emplace_back(resource.lastPass, handle);
+            plan.push_back({ resource.desc, resource.usage, static_cast<uint32_t>(blockEnds.size() - 1) });
+            continue;
+        }
+        resource.aliasOf = static_cast<int>(block->second);
+        *block = { resource.lastPass, handle };
+        plan.push_back({ resource.desc, resource.usage, static_cast<uint32_t>(block - blockEnds.begin()) });
+    }
+
+    // same frame structure as last time, keep the images and memory
+    if (plan != _plan) {
+        destroyTransients(); // the caller waited for the previous execution of this graph
+        _plan = std::move(plan);
+
+        auto& device = Context::GetInstance().device;
+        std::vector<vk::MemoryRequirements> blockRequirements(blockEnds.size(), vk::MemoryRequirements(0, 0, ~0u));
+        for (const auto& allocation : _plan) {
+            vk::ImageCreateInfo createInfo;
+            createInfo
+            .setImageType(vk::ImageType::e2D)
+            .setArrayLayers(1)
+            .setMipLevels(1)
+            .setExtent({ allocation.desc.extent.width, allocation.desc.extent.height, 1 })
+            .setFormat(allocation.desc.format)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setUsage(allocation.usage)
+            .setSamples(vk::SampleCountFlagBits::e1);
+            auto image = device.createImage(createInfo);
+            _physical.push_back({ image, nullptr });
+
+            // a block is as big as its largest image and usable by every one of them
+            auto requirements = device.getImageMemoryRequirements(image);
+            auto& block = blockRequirements[allocation.block];
+            block.size = std::max(block.size, requirements.size);
+            block.alignment = std::max(block.alignment, requirements.alignment);
+            block.memoryTypeBits &= requirements.memoryTypeBits;
+        }
+
+        for (const auto& requirements : blockRequirements) {
+            _blocks.push_back(Context::GetInstance().memoryManager->Allocate(requirements, std::array { MemoryRequest::DeviceOnly() },
+                                                                        MemoryCategory::Attachment));
+        }
+
+        for (size_t i = 0; i < _plan.size(); ++i) {
+            auto& physical = _physical[i];
+            device.bindImageMemory(physical.image, _blocks[_plan[i].block], 0);
+
+            vk::ImageViewCreateInfo createInfo;
+            createInfo
+            .setImage(physical.image)
+            .setFormat(_plan[i].desc.format)
+            .setViewType(vk::ImageViewType::e2D)
+            .setSubresourceRange(colorRange);
+            physical.view = device.createImageView(createInfo);
+        }
+    }
+
+    for (size_t i = 0; i < transients.size(); ++i) {
+        _resources[transients[i]].image = _physical[i].image;
+        _resources[transients[i]].view = _physical[i].view;
+    }
+}
+
+void RenderGraph::destroyTransients() {
+    if (_plan.empty()) return;
+    auto& device = Context::GetInstance().device;
+    for (auto& physical : _physical) {
+        device.destroyImageView(physical.view);
+        device.destroyImage(physical.image);
+    }
+    for (auto& block : _blocks) Context::GetInstance().memoryManager->Free(block);
+    _physical.clear();
+    _blocks.clear();
+    _plan.clear();
+}
+
+void RenderGraph::computeBarriers() {
+    _finalImageBarriers.clear();
+    _finalMemoryBarriers.clear();
+
+    std::vector<ResourceState> states(_resources.size());
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        auto info = getAccessInfo(_resources[i].initialAccess);
+        auto& state = states[i];
+        state.layout = info.layout;
+        if (info.write) {
+            state.writeStage = info.stage;
+            state.writeAccess = info.access;
+        } else {
+            state.readStages = info.stage;
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(_passes.size()); ++i) {
+        auto& pass = _passes[i];
+        pass.imageBarriers.clear();
+        pass.memoryBarriers.clear();
+        if (pass.culled) continue;
+
+        for (const auto* uses : { &pass.reads, &pass.writes }) {
+            for (const auto& use : *uses) {
+                const auto& resource = _resources[use.resource];
+                // aliased memory: wait for the previous occupant before overwriting it
+                const ResourceState* aliased = nullptr;
+                if (resource.firstPass == i && resource.aliasOf >= 0) aliased = &states[resource.aliasOf];
+                addBarrier(states[use.resource], resource, aliased, getAccessInfo(use.access), pass.imageBarriers, pass.memoryBarriers);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _resources.size(); ++i) {
+        const auto& resource = _resources[i];
+        if (!resource.finalAccess.has_value()) continue;
+        addBarrier(states[i], resource, nullptr, getAccessInfo(*resource.finalAccess), _finalImageBarriers, _finalMemoryBarriers);
+    }
+}
+
+void RenderGraph::addBarrier(ResourceState& state, const Resource& resource, const ResourceState* aliased, const AccessInfo& info,
+                             std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::MemoryBarrier2>& memoryBarriers) {
+    bool transition = resource.isImage && state.layout != info.layout;
+
+    vk::PipelineStageFlags2 srcStage;
+    vk::AccessFlags2 srcAccess = state.writeAccess;
+    bool needed;
+    if (transition || info.write) {
+        // write after read needs execution order only, write after write also the memory dependency
+        srcStage = state.writeStage | state.readStages;
+        needed = transition || srcStage;
+    } else {
+        // read after write, once per reading stage
+        srcStage = state.writeStage;
+        needed = state.writeStage && (info.stage & ~state.visibleStages);
+    }
+    if (aliased != nullptr) {
+        srcStage |= aliased->writeStage | aliased->readStages;
+        srcAccess |= aliased->writeAccess;
+        needed = needed || srcStage;
+    }
+
+    if (needed) {
+        if (resource.isImage) {
+            vk::ImageMemoryBarrier2 barrier;
+            barrier
+            .setSrcStageMask(srcStage)
+            .setSrcAccessMask(srcAccess)
+            .setDstStageMask(info.stage)
+            .setDstAccessMask(info.access)
+            .setOldLayout(transition ? state.layout : info.layout)
+            .setNewLayout(info.layout)
+            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+            .setImage(resource.image)
+            .setSubresourceRange(colorRange);
+            imageBarriers.push_back(barrier);
+        } else {
+            // buffers share one global barrier per pass, as cheap as per-buffer ones on every driver
+            if (memoryBarriers.empty()) memoryBarriers.emplace_back();
+            auto& barrier = memoryBarriers.front();
+            barrier
+            .setSrcStageMask(barrier.srcStageMask | srcStage)
+            .setSrcAccessMask(barrier.srcAccessMask | srcAccess)
+            .setDstStageMask(barrier.dstStageMask | info.stage)
+            .setDstAccessMask(barrier.dstAccessMask | info.access);
+        }
+    }
+
+    if (info.write) {
+        state.writeStage = info.stage;
+        state.writeAccess = info.access;
+        state.readStages = {};
+        state.visibleStages = {};
+    } else if (transition) {
+        // the transition itself is the last write, its results are available to this stage only
+        state.writeStage = info.stage;
+        state.writeAccess = {};
+        state.readStages = info.stage;
+        state.visibleStages = info.stage;
+    } else {
+        state.readStages |= info.stage;
+        if (needed) state.visibleStages |= info.stage;
+    }
+    state.layout = info.layout;
+}
+
+void RenderGraph::PipelineBarrier(vk::CommandBuffer& cmdBuf,
+                                  const std::vector<vk::ImageMemoryBarrier2>& imageBarriers,
+                                  const std::vector<vk::MemoryBarrier2>& memoryBarriers) {
+    if (Context::GetInstance().features.synchronization2) {
+        vk::DependencyInfo dependency;
+        dependency
+        .setImageMemoryBarriers(imageBarriers)
+        .setMemoryBarriers(memoryBarriers);
+        cmdBuf.pipelineBarrier2(dependency);
+        return;
+    }
+
+    // legacy barrier, the graph only uses stage and access bits that keep their values
+    auto toStage = [](vk::PipelineStageFlags2 flags) {
+        return vk::PipelineStageFlags(static_cast<VkPipelineStageFlags>(static_cast<VkPipelineStageFlags2>(flags)));
+    };
+    auto toAccess = [](vk::AccessFlags2 flags) {
+        return vk::AccessFlags(static_cast<VkAccessFlags>(static_cast<VkAccessFlags2>(flags)));
+    };
+
+    vk::PipelineStageFlags srcStage, dstStage;
+    std::vector<vk::ImageMemoryBarrier> legacyImageBarriers;
+    std::vector<vk::MemoryBarrier> legacyMemoryBarriers;
+    for (const auto& barrier : imageBarriers) {
+        srcStage |= toStage(barrier.srcStageMask);
+        dstStage |= toStage(barrier.dstStageMask);
+        legacyImageBarriers.emplace_back(toAccess(barrier.srcAccessMask), toAccess(barrier.dstAccessMask),
+                                         barrier.oldLayout, barrier.newLayout,
+                                         barrier.srcQueueFamilyIndex, barrier.dstQueueFamilyIndex,
+                                         barrier.image, barrier.subresourceRange);
+    }
+    for (const auto& barrier : memoryBarriers) {
+        srcStage |= toStage(barrier.srcStageMask);
+        dstStage |= toStage(barrier.dstStageMask);
+        legacyMemoryBarriers.emplace_back(toAccess(barrier.srcAccessMask), toAccess(barrier.dstAccessMask));
+    }
+    if (!srcStage) srcStage = vk::PipelineStageFlagBits::eTopOfPipe;
+    if (!dstStage) dstStage = vk::PipelineStageFlagBits::eBottomOfPipe;
+    cmdBuf.pipelineBarrier(srcStage, dstStage, {}, legacyMemoryBarriers, {}, legacyImageBarriers);
+}
+
+vk::Image RenderGraph::getImage(ResourceHandle resource) {
+    return _resources.at(resource).image;
+}
+
+vk::ImageView RenderGraph::getImageView(ResourceHandle resource) {
+    return _resources.at(resource).view;
+}
+
+vk::Buffer RenderGraph::getBuffer(ResourceHandle resource) {
+    return _resources.at(resource).buffer;
+}
+
+size_t RenderGraph::getCulledPassCount() const {
+    return std::ranges::count(_passes, true, &Pass::culled);
+}
+
+}
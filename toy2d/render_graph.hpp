@@ -0,0 +1,176 @@
+/**
+  * @file   render_graph.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace toy2d {
+
+// passes declare how they use images and buffers, the graph orders them and inserts the barriers
+class RenderGraph {
+public:
+    using ResourceHandle = uint32_t;
+    using ExecuteFunc = std::function<void(vk::CommandBuffer& cmdBuf)>;
+
+    // every use maps to one (stage, access, layout) triple, see getAccessInfo()
+    enum class Access {
+        None,                 // undefined contents
+        SwapchainAcquire,     // undefined contents, ready once the acquire semaphore wait at color output passed
+        ColorAttachmentWrite,
+        ColorAttachmentRead,  // blending or load op load
+        VertexShaderRead,     // sampled image or storage/uniform buffer
+        FragmentShaderRead,
+        VertexBufferRead,
+        IndexBufferRead,
+        TransferRead,
+        TransferWrite,
+        HostWrite,            // host-visible buffers written before the submit
+        Present,
+    };
+
+    struct ImageDesc {
+        vk::Extent2D extent;
+        vk::Format format;
+
+        bool operator==(const ImageDesc& other) const = default;
+    };
+
+    class PassBuilder {
+    private:
+        friend class RenderGraph;
+        RenderGraph& _graph;
+        size_t _pass;
+
+        PassBuilder(RenderGraph& graph, size_t pass) : _graph(graph), _pass(pass) {}
+
+    public:
+        PassBuilder& Read(ResourceHandle resource, Access access);
+        PassBuilder& Write(ResourceHandle resource, Access access);
+        PassBuilder& SideEffect(); // never culled, e.g. readbacks
+    };
+
+private:
+    struct AccessInfo {
+        vk::PipelineStageFlags2 stage;
+        vk::AccessFlags2 access;
+        vk::ImageLayout layout;
+        bool write;
+    };
+
+    struct Use {
+        ResourceHandle resource;
+        Access access;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<Use> reads;
+        std::vector<Use> writes;
+        ExecuteFunc execute;
+        bool sideEffect = false;
+        bool culled = false;
+
+        // recorded right before execute, all in one pipelineBarrier2
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+        std::vector<vk::MemoryBarrier2> memoryBarriers;
+    };
+
+    struct Resource {
+        std::string name;
+        bool isImage;
+        bool imported;
+        Access initialAccess = Access::None;
+        std::optional<Access> finalAccess; // imported resources only
+
+        ImageDesc desc;
+        vk::ImageUsageFlags usage; // transient images, derived from their uses
+        vk::Image image;
+        vk::ImageView view;
+        vk::Buffer buffer;
+
+        int firstPass = -1;
+        int lastPass = -1;
+        int aliasOf = -1; // transient image that used the same memory before this one
+    };
+
+    // state tracked while compiling barriers
+    struct ResourceState {
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+        vk::PipelineStageFlags2 writeStage;
+        vk::AccessFlags2 writeAccess;
+        vk::PipelineStageFlags2 readStages;   // since the last write, a later write waits for them
+        vk::PipelineStageFlags2 visibleStages; // stages the last write was already made visible to
+    };
+
+    // transient memory, kept while the allocation plan stays the same
+    struct Allocation {
+        ImageDesc desc;
+        vk::ImageUsageFlags usage;
+        uint32_t block;
+
+        bool operator==(const Allocation& other) const = default;
+    };
+
+    struct Physical {
+        vk::Image image;
+        vk::ImageView view;
+    };
+
+    std::vector<Pass> _passes;
+    std::vector<Resource> _resources;
+    std::vector<vk::ImageMemoryBarrier2> _finalImageBarriers;
+    std::vector<vk::MemoryBarrier2> _finalMemoryBarriers;
+
+    std::vector<Allocation> _plan;
+    std::vector<Physical> _physical;
+    std::vector<vk::DeviceMemory> _blocks;
+
+public:
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+    ~RenderGraph();
+
+    ResourceHandle ImportImage(std::string name, vk::Image image, vk::ImageView view,
+                               Access initialAccess, std::optional<Access> finalAccess = {});
+    ResourceHandle ImportBuffer(std::string name, vk::Buffer buffer,
+                                Access initialAccess = Access::None, std::optional<Access> finalAccess = {});
+    ResourceHandle CreateImage(std::string name, const ImageDesc& desc); // transient, may share memory with others
+
+    void AddPass(std::string name, const std::function<void(PassBuilder& builder)>& setup, ExecuteFunc execute);
+
+    void Compile(); // culls passes, places transient images and computes barriers
+    void Execute(vk::CommandBuffer& cmdBuf);
+    void Reset();   // forgets passes and resources for the next frame, transient memory is kept
+
+    vk::Image getImage(ResourceHandle resource);
+    vk::ImageView getImageView(ResourceHandle resource);
+    vk::Buffer getBuffer(ResourceHandle resource);
+    size_t getCulledPassCount() const;
+
+    static void PipelineBarrier(vk::CommandBuffer& cmdBuf,
+                                const std::vector<vk::ImageMemoryBarrier2>& imageBarriers,
+                                const std::vector<vk::MemoryBarrier2>& memoryBarriers);
+
+private:
+    static AccessInfo getAccessInfo(Access access);
+    void cullPasses();
+    void computeLifetimes();
+    void allocateTransients();
+    void destroyTransients();
+    void computeBarriers();
+    void addBarrier(ResourceState& state, const Resource& resource, const ResourceState* aliased, const AccessInfo& info,
+                    std::vector<vk::ImageMemoryBarrier2>& imageBarriers, std::vector<vk::MemoryBarrier2>& memoryBarriers);
+};
+
+}
@@ -8,116 +8,16 @@
 #include "render_process.hpp"
 
 #include "context.hpp"
-#include "shader.hpp"
-#include "vertex.hpp"
-#include "uniform.hpp"
 
 namespace toy2d {
 
-RenderProcess::RenderProcess(int width, int height) {
-    InitLayout();
-    InitRenderPass();
-    InitPipeline(width, height);
+RenderProcess::RenderProcess() {
+    dynamicRendering = Context::GetInstance().features.dynamicRendering;
+    if (!dynamicRendering) InitRenderPass(); // fallback for pre-1.3 devices
 }
 
 RenderProcess::~RenderProcess() {
-    auto& device = Context::GetInstance().device;
-    device.destroyPipeline(pipeline);
-    device.destroyRenderPass(renderPass);
-    device.destroyPipelineLayout(layout);
-}
-
-void RenderProcess::InitPipeline(int width, int height) {
-    vk::GraphicsPipelineCreateInfo createInfo;
-
-    // 1. Vertex Input
-    vk::PipelineVertexInputStateCreateInfo inputState;
-    auto attribute = vec2::getAttribute(); // TODO: refactor for multiple vertex types
-    auto binding = vec2::getBinding();
-    inputState
-    .setVertexAttributeDescriptions(attribute)
-    .setVertexBindingDescriptions(binding);
-    createInfo.setPVertexInputState(&inputState);
-
-    // 2. Vertex Assembly
-    vk::PipelineInputAssemblyStateCreateInfo asmState;
-    asmState
-    .setPrimitiveRestartEnable(false) // disable primitive restart
-    .setTopology(vk::PrimitiveTopology::eTriangleList);
-    createInfo.setPInputAssemblyState(&asmState);
-
-    // 3. Shader
-    auto stages = Shader::GetInstance().getStages();
-    createInfo.setStages(stages);
-
-    // 4. Viewport State
-    vk::PipelineViewportStateCreateInfo viewportState;
-    vk::Viewport viewport(0, 0, width, height, 0, 1);
-    vk::Rect2D scissor({0, 0}, {static_cast<uint32_t>(width), static_cast<uint32_t>(height)});
-    viewportState
-    .setViewports(viewport)
-    .setScissors(scissor);
-    createInfo.setPViewportState(&viewportState);
-
-    // 5. Rasterization
-    vk::PipelineRasterizationStateCreateInfo rasterState;
-    rasterState
-    .setRasterizerDiscardEnable(false) // if true then no output to framebuffer
-    .setCullMode(vk::CullModeFlagBits::eBack)
-    .setFrontFace(vk::FrontFace::eClockwise)
-    .setPolygonMode(vk::PolygonMode::eFill)
-    .setLineWidth(1); // no depth settings needed for 2D
-    createInfo.setPRasterizationState(&rasterState);
-
-    // 6. Multisample
-    vk::PipelineMultisampleStateCreateInfo multisample;
-    multisample
-    .setSampleShadingEnable(false) // disable multisampling
-    .setRasterizationSamples(vk::SampleCountFlagBits::e1);
-    createInfo.setPMultisampleState(&multisample);
-
-    // 7. Test (No need for 2D)
-
-    // 8. Color Blending
-    // NewColor = SrcAlpha * SrcColor + (1 - SrcAlpha) * DstColor
-    // NewAlpha = 1 * SrcAlpha + 0 * DstAlpha
-    vk::PipelineColorBlendStateCreateInfo blend;
-    vk::PipelineColorBlendAttachmentState attach;
-    attach
-    .setBlendEnable(true)
-    .setColorWriteMask(vk::ColorComponentFlagBits::eA | vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB)
-    .setSrcColorBlendFactor(vk::BlendFactor::eSrcAlpha)
-    .setDstColorBlendFactor(vk::BlendFactor::eOneMinusSrcAlpha)
-    .setColorBlendOp(vk::BlendOp::eAdd)
-    .setSrcAlphaBlendFactor(vk::BlendFactor::eOne)
-    .setDstAlphaBlendFactor(vk::BlendFactor::eZero)
-    .setAlphaBlendOp(vk::BlendOp::eAdd);
-    blend
-    .setLogicOpEnable(false) // disable logic operations
-    .setAttachments(attach);
-    createInfo.setPColorBlendState(&blend);
-
-    // 9. Layout
-    createInfo.setLayout(layout);
-
-    // 10. Render Pass
-    createInfo.setRenderPass(renderPass);
-
-    auto result = Context::GetInstance().device.createGraphicsPipeline(nullptr, createInfo);
-    if (result.result != vk::Result::eSuccess) {
-        throw std::runtime_error("Failed to create graphics pipeline.");
-    }
-    pipeline = result.value;
-}
-
-void RenderProcess::InitLayout() {
-    auto& device = Context::GetInstance().device;
-    vk::PipelineLayoutCreateInfo createInfo;
-
-    auto descriptorSetLayout = Shader::GetInstance().getDescriptorSetLayout();
-
-    createInfo.setSetLayouts(descriptorSetLayout);
-    layout = device.createPipelineLayout(createInfo);
+    Context::GetInstance().device.destroyRenderPass(renderPass);
 }
 
 void RenderProcess::InitRenderPass() {
@@ -128,7 +28,7 @@ void RenderProcess::InitRenderPass() {
     attachDesc
     .setFormat(Context::GetInstance().swapchain->info.format.format)
     .setInitialLayout(vk::ImageLayout::eUndefined)
-    .setFinalLayout(vk::ImageLayout::ePresentSrcKHR)
+    .setFinalLayout(vk::ImageLayout::eColorAttachmentOptimal) // the render graph transitions it for present
     .setLoadOp(vk::AttachmentLoadOp::eClear)
     .setStoreOp(vk::AttachmentStoreOp::eStore)
     .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare) // no stencil currently
@@ -11,18 +11,16 @@
 
 namespace toy2d {
 
+// pipelines are owned by the PipelineRegistry
 class RenderProcess {
 public:
-    vk::Pipeline pipeline;
-    vk::PipelineLayout layout;
-    vk::RenderPass renderPass;
+    vk::RenderPass renderPass; // null with dynamic rendering, pipelines then only need the attachment format
+    bool dynamicRendering;
 
 public:
-    RenderProcess(int width, int height);
+    RenderProcess();
     ~RenderProcess();
 
-    void InitPipeline(int width, int height);
-    void InitLayout();
     void InitRenderPass();
 };
 
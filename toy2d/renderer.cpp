@@ -10,30 +10,52 @@
 #include "context.hpp"
 #include "shader.hpp"
 
+#include <algorithm>
+
 namespace toy2d {
 
-Renderer::Renderer(int maxFlightCount) : _maxFlightCount(maxFlightCount) {
+Renderer::Renderer(int maxFlightCount) : _maxFlightCount(maxFlightCount), _deletionQueue(maxFlightCount) {
     allocCommandBuffer();
     createSemaphores();
     createFences();
+    createDynamicBuffers();
     createSampler();
     SetTexture("resources/texture.png");
-    createUniformBuffer(sizeof(UniformObject));
-    createDescriptorPool();
-    allocDescriptorSets();
-    updateDescriptorSets();
+    createUniformRing(1 << 20); // 1 MiB per frame, thousands of uniform blocks
+    createDescriptorAllocators();
+    createRenderGraphs();
+
+    auto& registry = Context::GetInstance().pipelineRegistry;
+    _defaultPipeline = registry->Request({ .program = registry->FindProgram("texture") });
+    _boundPipeline = _defaultPipeline;
+    registry->Get(_defaultPipeline); // built up front, it is the fallback for everything else
+
+    _spritePipeline = registry->Request({ .program = registry->FindProgram("sprite"), .vertexLayout = MakeVertexLayout<SpriteVertex>() });
+    registry->CompileAsync(_spritePipeline);
+    _spritePullPipeline = registry->Request({ .program = registry->FindProgram("sprite-pull") });
+    registry->CompileAsync(_spritePullPipeline);
+    if (Context::GetInstance().features.bufferDeviceAddress) {
+        _spriteScenePipeline = registry->Request({ .program = registry->FindProgram("sprite-scene") });
+        registry->CompileAsync(*_spriteScenePipeline);
+    }
 }
 
 Renderer::~Renderer() {
     auto& device = Context::GetInstance().device;
     auto& cmdMgr = Context::GetInstance().commandManager;
     device.destroySampler(_sampler);
-    device.destroyDescriptorPool(_descriptorPool);
-    _hostVertexBuffer.reset();
-    _deviceVertexBuffer.reset();
-    _hostIndexBuffer.reset();
-    _deviceIndexBuffer.reset();
-    _uniformBuffers.clear();
+    _frameGraphs.clear();
+    _frameDescriptorAllocators.clear();
+    _descriptorCache.reset();
+    _vertexBuffer.reset();
+    _indexBuffer.reset();
+    _spriteVertexBuffer.reset();
+    _spriteIndexBuffer.reset();
+    _spriteRecordBuffer.reset();
+    _sceneRecordBuffer.reset();
+    _sceneLayerBuffer.reset();
+    _deletionQueue.Flush(); // the device is idle by now
+    _uniformRing.reset();
     for (auto& sem : _imageAvailableSems) device.destroySemaphore(sem);
     for (auto& sem : _imageRenderFinishedSems) device.destroySemaphore(sem);
     for (auto& fence : _cmdAvailableFences) device.destroyFence(fence);
@@ -65,188 +87,99 @@ void Renderer::createFences() {
     for (auto& fence : _cmdAvailableFences) fence = device.createFence(createInfo);
 }
 
-void Renderer::createVertexBuffer(size_t size) {
-    // Coherent Memory (Simpler):
-    // _vertexBuffer.reset(new Buffer(
-    //     size,
-    //     vk::BufferUsageFlagBits::eVertexBuffer,
-    //     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-    // ));
-
-     _hostVertexBuffer.reset(new Buffer(
-         size,
-         vk::BufferUsageFlagBits::eTransferSrc,
-         vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-     ));
-     _deviceVertexBuffer.reset(new Buffer(
-         size,
-         vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-         vk::MemoryPropertyFlagBits::eDeviceLocal
-     ));
+void Renderer::createDynamicBuffers() {
+    // a few bytes set again and again, mostly unchanged
+    _vertexBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eVertexBuffer, _deletionQueue, DynamicBuffer::Diff::HostCopy));
+    _indexBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eIndexBuffer, _deletionQueue, DynamicBuffer::Diff::HostCopy));
+    // rebuilt from the batches every time, a host copy would only double the memory
+    _spriteVertexBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eVertexBuffer, _deletionQueue));
+    _spriteIndexBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eIndexBuffer, _deletionQueue));
+    _spriteRecordBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eStorageBuffer, _deletionQueue));
+    if (Context::GetInstance().features.bufferDeviceAddress) {
+        _sceneRecordBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eShaderDeviceAddress, _deletionQueue));
+        _sceneLayerBuffer.reset(new DynamicBuffer(vk::BufferUsageFlagBits::eShaderDeviceAddress, _deletionQueue));
+    }
 }
 
-void Renderer::bufferVertexData(void* data) {
+void Renderer::flushDynamicBuffers(vk::CommandBuffer& cmdBuf) {
+    // the current frame's fence was waited, with no other frame in flight unified memory can be written in place
     auto& device = Context::GetInstance().device;
+    bool inUse = false;
+    for (int i = 0; i < _maxFlightCount; ++i) {
+        if (i != _curFrame && device.getFenceStatus(_cmdAvailableFences[i]) != vk::Result::eSuccess) inUse = true;
+    }
 
-    // Coherent Memory (Simpler):
-    // void* mapped = device.mapMemory(_vertexBuffer->memory, 0, _vertexBuffer->size); {
-    //     std::memcpy(mapped, data, _vertexBuffer->size);
-    // } device.unmapMemory(_vertexBuffer->memory);
-
-    auto& ctx = Context::GetInstance();
-
-    void* mapped = device.mapMemory(_hostVertexBuffer->memory, 0, _hostVertexBuffer->size); {
-        std::memcpy(mapped, data, _hostVertexBuffer->size);
-    } device.unmapMemory(_hostVertexBuffer->memory);
-
-    auto cmdBuf = ctx.commandManager->AllocCommandBuffer();
-    vk::CommandBufferBeginInfo beginInfo;
-    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    cmdBuf.begin(beginInfo); {
-        vk::BufferCopy region;
-        region.setSrcOffset(0).setDstOffset(0).setSize(_hostVertexBuffer->size);
-        cmdBuf.copyBuffer(_hostVertexBuffer->buffer, _deviceVertexBuffer->buffer, region);
-    } cmdBuf.end();
-
-    vk::SubmitInfo submit;
-    submit.setCommandBuffers(cmdBuf);
-    ctx.graphicsQueue.submit(submit);
-
-    // wait for transfer to finish
-    ctx.device.waitIdle();
-
-    ctx.commandManager->FreeCommandBuffer(cmdBuf);
-}
-
-void Renderer::createIndexBuffer(size_t size) {
-    _hostIndexBuffer.reset(new Buffer(
-            size,
-            vk::BufferUsageFlagBits::eTransferSrc,
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-    ));
-    _deviceIndexBuffer.reset(new Buffer(
-            size,
-            vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst,
-            vk::MemoryPropertyFlagBits::eDeviceLocal
-    ));
-}
-
-void Renderer::bufferIndexData(void* data) {
-    auto& ctx = Context::GetInstance();
-
-    void* mapped = ctx.device.mapMemory(_hostIndexBuffer->memory, 0, _hostIndexBuffer->size); {
-        std::memcpy(mapped, data, _hostIndexBuffer->size);
-    } ctx.device.unmapMemory(_hostIndexBuffer->memory);
-
-    auto cmdBuf = ctx.commandManager->AllocCommandBuffer();
-    vk::CommandBufferBeginInfo beginInfo;
-    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    cmdBuf.begin(beginInfo); {
-        vk::BufferCopy region;
-        region.setSrcOffset(0).setDstOffset(0).setSize(_hostIndexBuffer->size);
-        cmdBuf.copyBuffer(_hostIndexBuffer->buffer, _deviceIndexBuffer->buffer, region);
-    } cmdBuf.end();
-
-    vk::SubmitInfo submit;
-    submit.setCommandBuffers(cmdBuf);
-    ctx.graphicsQueue.submit(submit);
-
-    // wait for transfer to finish
-    ctx.device.waitIdle();
-
-    ctx.commandManager->FreeCommandBuffer(cmdBuf);
-}
-
-void Renderer::createUniformBuffer(size_t size) {
-    _uniformBuffers.resize(_maxFlightCount);
-
-    for (auto& buffer : _uniformBuffers) {
-        buffer.reset(new Buffer(
-            size,
-            vk::BufferUsageFlagBits::eUniformBuffer,
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-        ));
+    for (auto buffer : { _vertexBuffer.get(), _indexBuffer.get(), _spriteVertexBuffer.get(), _spriteIndexBuffer.get(),
+                         _spriteRecordBuffer.get(), _sceneRecordBuffer.get(), _sceneLayerBuffer.get() }) {
+        if (buffer && buffer->dirty()) buffer->Flush(cmdBuf, inUse);
     }
 }
 
-void Renderer::bufferUniformData(void* data) {
-    auto& device = Context::GetInstance().device;
-
-    for (auto& buffer : _uniformBuffers) {
-        void* mapped = device.mapMemory(buffer->memory, 0, buffer->size); {
-            std::memcpy(mapped, data, buffer->size);
-        } device.unmapMemory(buffer->memory);
+void Renderer::requireNotRecording(std::string_view caller) {
+    // a copy cannot be recorded inside a render pass, and passes recorded earlier would draw the old contents
+    if (_recording) {
+        throw std::runtime_error(std::string(caller) + " was called from a pass callback, set data before Render() or while building the graph.");
     }
 }
 
-void Renderer::createDescriptorPool() {
-    vk::DescriptorPoolCreateInfo createInfo;
-    std::vector<vk::DescriptorPoolSize> poolSizes(2);
-
-    poolSizes[0]
-    .setType(vk::DescriptorType::eUniformBuffer) // for uniform
-    .setDescriptorCount(_maxFlightCount);
-
-     poolSizes[1]
-     .setType(vk::DescriptorType::eCombinedImageSampler) // for sampler image
-     .setDescriptorCount(_maxFlightCount);
-
-    createInfo
-    .setMaxSets(_maxFlightCount)
-    .setPoolSizes(poolSizes);
-    _descriptorPool = Context::GetInstance().device.createDescriptorPool(createInfo);
+void Renderer::createUniformRing(size_t size) {
+    _uniformRing.reset(new UniformRing(size, _maxFlightCount));
 }
 
-void Renderer::allocDescriptorSets() {
-    auto& ctx = Context::GetInstance();
-
-    auto descriptorSetLayout = Shader::GetInstance().getDescriptorSetLayout();
-    std::vector<vk::DescriptorSetLayout> layouts(_maxFlightCount, descriptorSetLayout);
+void Renderer::createDescriptorAllocators() {
+    _descriptorCache.reset(new DescriptorCache);
 
-    vk::DescriptorSetAllocateInfo allocInfo;
-    allocInfo
-    .setDescriptorPool(_descriptorPool)
-    .setDescriptorSetCount(_maxFlightCount)
-    .setSetLayouts(layouts);
-    _descriptorSets = ctx.device.allocateDescriptorSets(allocInfo);
+    _frameDescriptorAllocators.resize(_maxFlightCount);
+    for (auto& allocator : _frameDescriptorAllocators) allocator.reset(new DescriptorAllocator(16));
 }
 
-void Renderer::updateDescriptorSets() {
-    auto& ctx = Context::GetInstance();
-    for (size_t i = 0; i < _descriptorSets.size(); ++i) {
-        auto& descriptorSet = _descriptorSets[i];
-        std::vector<vk::WriteDescriptorSet> writers(2);
-        std::vector<vk::DescriptorBufferInfo> bufferInfos(1);
-        std::vector<vk::DescriptorImageInfo> imageInfos(1);
-
-        // uniform
-        bufferInfos[0]
-        .setBuffer(_uniformBuffers[i]->buffer)
-        .setOffset(0)
-        .setRange(_uniformBuffers[i]->size);
-        writers[0]
-        .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-        .setDescriptorCount(1)
-        .setDstSet(descriptorSet)
-        .setDstBinding(0)
-        .setDstArrayElement(0)
-        .setBufferInfo(bufferInfos[0]);
-
-        // sampler
-        imageInfos[0]
-        .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-        .setImageView(_texture->view)
-        .setSampler(_sampler);
-        writers[1]
-        .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-        .setDescriptorCount(1)
-        .setDstSet(descriptorSet)
-        .setDstBinding(1)
-        .setDstArrayElement(0)
-        .setImageInfo(imageInfos[0]);
-
-        ctx.device.updateDescriptorSets(writers, {}); // what is descriptor copies?
+const std::vector<vk::DescriptorSet>& Renderer::getDescriptorSets(ProgramHandle program) {
+    if (auto it = _descriptorSets.find(program); it != _descriptorSets.end()) return it->second;
+
+    auto& shader = Context::GetInstance().pipelineRegistry->getShader(program);
+    auto descriptorSetLayout = shader.getDescriptorSetLayout();
+
+    auto& descriptorSets = _descriptorSets[program];
+    descriptorSets.resize(_maxFlightCount);
+    for (size_t i = 0; i < descriptorSets.size(); ++i) {
+        // resources are matched to the reflected bindings by descriptor type
+        std::vector<DescriptorBinding> bindings;
+        for (const auto& layoutBinding : shader.getBindings()) {
+            DescriptorBinding binding { .binding = layoutBinding.binding, .type = layoutBinding.descriptorType };
+            switch (layoutBinding.descriptorType) {
+            case vk::DescriptorType::eUniformBufferDynamic:
+                // each draw adds its dynamic offset to the base of the frame region
+                binding.buffer
+                .setBuffer(_uniformRing->getBuffer())
+                .setOffset(_uniformRing->getRegionOffset(i))
+                .setRange(sizeof(UniformObject));
+                break;
+            case vk::DescriptorType::eStorageBuffer:
+                // the only storage buffer so far, records for vertex pulling
+                if (_spriteRecordBuffer->size() == 0) {
+                    throw std::runtime_error("Shader reads a storage buffer, but no sprite records were set.");
+                }
+                binding.buffer
+                .setBuffer(_spriteRecordBuffer->getBuffer())
+                .setOffset(0)
+                .setRange(VK_WHOLE_SIZE);
+                break;
+            case vk::DescriptorType::eCombinedImageSampler:
+                binding.image
+                .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+                .setImageView(_texture->view)
+                .setSampler(_sampler);
+                break;
+            default:
+                throw std::runtime_error("Renderer has no resource for a descriptor type used by the shader.");
+            }
+            bindings.push_back(binding);
+        }
+
+        // programs with the same set 0 interface share their sets
+        descriptorSets[i] = _descriptorCache->Get(descriptorSetLayout, bindings);
     }
+    return descriptorSets;
 }
 
 void Renderer::createSampler() {
@@ -266,59 +199,253 @@ void Renderer::createSampler() {
 }
 
 void Renderer::InitTriangle() {
-    createVertexBuffer(sizeof(vec2[3]));
+    _vertexBuffer->Reserve(sizeof(vec2[3]));
 }
 
 void Renderer::SetTriangle(const std::array<vec2, 3>& vertices) {
-    bufferVertexData((void*)vertices.data());
+    requireNotRecording("SetTriangle");
+    _vertexBuffer->Assign(vertices.data(), sizeof(vertices));
 }
 
 void Renderer::DrawTriangle() {
-    auto& renderProcess = Context::GetInstance().renderProcess;
-    auto& _descriptorSet = _descriptorSets[_curFrame];
     Render([&](vk::CommandBuffer& cmdBuf) {
-        cmdBuf.bindPipeline(vk::PipelineBindPoint::eGraphics, renderProcess->pipeline);
-        cmdBuf.bindVertexBuffers(0, _deviceVertexBuffer->buffer, {0});
-        cmdBuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, renderProcess->layout, 0, _descriptorSet, {});
+        BindPipeline(cmdBuf, _defaultPipeline);
+        cmdBuf.bindVertexBuffers(0, _vertexBuffer->getBuffer(), {0});
+        BindDescriptorSet(cmdBuf, _uniformObject);
+        PushConstants(cmdBuf, PushConstantObject());
         cmdBuf.draw(3, 1, 0, 0); // draw one triangle with 3 vertices
     });
 }
 
 void Renderer::InitRectangle() {
-    createVertexBuffer(sizeof(vec2[4]));
-    createIndexBuffer(sizeof(uint32_t[6]));
+    _vertexBuffer->Reserve(sizeof(vec2[4]));
+    _indexBuffer->Reserve(sizeof(uint32_t[6]));
 }
 
 void Renderer::SetRectangle(const std::array<vec2, 4>& vertices, const std::array<uint32_t, 6>& indices) {
-    bufferVertexData((void*)vertices.data());
-    bufferIndexData((void*)indices.data());
+    requireNotRecording("SetRectangle");
+    _vertexBuffer->Assign(vertices.data(), sizeof(vertices));
+    _indexBuffer->Assign(indices.data(), sizeof(indices));
 }
 
 void Renderer::DrawRectangle() {
-    auto& renderProcess = Context::GetInstance().renderProcess;
-    auto& _descriptorSet = _descriptorSets[_curFrame];
+    DrawRectangle(PushConstantObject());
+}
+
+void Renderer::DrawRectangle(const PushConstantObject& pushConstant) {
+    DrawRectangle(pushConstant, _defaultPipeline);
+}
+
+void Renderer::DrawRectangle(const PushConstantObject& pushConstant, PipelineHandle pipeline, PipelineFallback fallback) {
     Render([&](vk::CommandBuffer& cmdBuf) {
-        cmdBuf.bindPipeline(vk::PipelineBindPoint::eGraphics, renderProcess->pipeline);
-        cmdBuf.bindVertexBuffers(0, _deviceVertexBuffer->buffer, {0});
-        cmdBuf.bindIndexBuffer(_deviceIndexBuffer->buffer, 0, vk::IndexType::eUint32);
-        cmdBuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, renderProcess->layout, 0, _descriptorSet, {});
-        cmdBuf.drawIndexed(6, 1, 0, 0, 0); // draw rectangle with 6 indices
+        DrawRectangle(cmdBuf, pushConstant, pipeline, fallback);
     });
 }
 
+void Renderer::DrawRectangle(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant, PipelineHandle pipeline,
+                             PipelineFallback fallback) {
+    if (!BindPipeline(cmdBuf, pipeline, fallback)) return;
+    cmdBuf.bindVertexBuffers(0, _vertexBuffer->getBuffer(), {0});
+    cmdBuf.bindIndexBuffer(_indexBuffer->getBuffer(), 0, vk::IndexType::eUint32);
+    BindDescriptorSet(cmdBuf, _uniformObject);
+    PushConstants(cmdBuf, pushConstant);
+    cmdBuf.drawIndexed(6, 1, 0, 0, 0); // draw rectangle with 6 indices
+}
+
+void Renderer::SetSprites(const SpriteBatch& batch) {
+    requireNotRecording("SetSprites");
+    std::vector<SpriteVertex> vertices;
+    std::vector<uint16_t> indices;
+    auto frame = batch.Build(vertices, indices);
+    if (indices.empty()) {
+        _spriteIndexCount = 0;
+        return;
+    }
+
+    _spriteVertexBuffer->Assign(vertices.data(), vertices.size() * sizeof(SpriteVertex));
+    _spriteIndexBuffer->Assign(indices.data(), indices.size() * sizeof(uint16_t));
+    _spriteIndexCount = static_cast<uint32_t>(indices.size());
+    _spriteFrame = frame;
+}
+
+void Renderer::DrawSprites(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant) {
+    // no fallback, the default pipeline reads a different vertex layout
+    if (_spriteIndexCount == 0 || !BindPipeline(cmdBuf, _spritePipeline)) return;
+    cmdBuf.bindVertexBuffers(0, _spriteVertexBuffer->getBuffer(), {0});
+    cmdBuf.bindIndexBuffer(_spriteIndexBuffer->getBuffer(), 0, vk::IndexType::eUint16);
+    BindDescriptorSet(cmdBuf, _uniformObject);
+    PushConstants(cmdBuf, _spriteFrame.Apply(pushConstant));
+    cmdBuf.drawIndexed(_spriteIndexCount, 1, 0, 0, 0);
+}
+
+void Renderer::SetSpriteRecords(const SpriteBatch& batch) {
+    requireNotRecording("SetSpriteRecords");
+    std::vector<SpriteRecord> records;
+    batch.BuildRecords(records);
+    _spriteRecordCount = static_cast<uint32_t>(records.size());
+    if (records.empty()) return;
+
+    auto previous = _spriteRecordBuffer->getBuffer();
+    _spriteRecordBuffer->Assign(records.data(), records.size() * sizeof(SpriteRecord));
+    if (_spriteRecordBuffer->getBuffer() != previous) {
+        // cached sets still point at the old buffer, frames in flight may still bind them
+        _deletionQueue.Push([cache = std::shared_ptr<DescriptorCache>(std::move(_descriptorCache))] {});
+        _descriptorCache.reset(new DescriptorCache);
+        _descriptorSets.clear();
+    }
+}
+
+uint32_t Renderer::GetSpriteRecordCount() {
+    return _spriteRecordCount;
+}
+
+void Renderer::DrawSpriteRecords(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant, uint32_t first, uint32_t count) {
+    if (first >= _spriteRecordCount) return;
+    count = std::min(count, _spriteRecordCount - first);
+    // the vertex layout is the shader's business, so there is nothing to bind but the pipeline and the records
+    if (!BindPipeline(cmdBuf, _spritePullPipeline)) return;
+    BindDescriptorSet(cmdBuf, _uniformObject);
+    PushConstants(cmdBuf, pushConstant);
+    cmdBuf.draw(6, count, 0, first); // firstInstance offsets gl_InstanceIndex into the records
+}
+
+bool Renderer::SetSpriteScene(std::span<const SpriteBatch> layers) {
+    requireNotRecording("SetSpriteScene");
+    if (!_spriteScenePipeline) return false;
+
+    // every layer's records in one buffer, the table holds a pointer to the first record of each
+    std::vector<SpriteRecord> records;
+    std::vector<SpriteRecord> layerRecords;
+    std::vector<size_t> firstRecords;
+    _sceneLayerCounts.clear();
+    for (const auto& layer : layers) {
+        layer.BuildRecords(layerRecords);
+        firstRecords.push_back(records.size());
+        _sceneLayerCounts.push_back(static_cast<uint32_t>(layerRecords.size()));
+        records.insert(records.end(), layerRecords.begin(), layerRecords.end());
+    }
+    if (records.empty()) {
+        _sceneLayerCounts.clear();
+        return true;
+    }
+
+    // a grown record buffer moves, so the table is rewritten every time
+    _sceneRecordBuffer->Assign(records.data(), records.size() * sizeof(SpriteRecord));
+
+    std::vector<SpriteLayer> table;
+    auto recordsAddress = _sceneRecordBuffer->getDeviceAddress();
+    for (size_t i = 0; i < firstRecords.size(); ++i) {
+        table.push_back({ recordsAddress + firstRecords[i] * sizeof(SpriteRecord), _sceneLayerCounts[i], 0 });
+    }
+    _sceneLayerBuffer->Assign(table.data(), table.size() * sizeof(SpriteLayer));
+    return true;
+}
+
+void Renderer::DrawSpriteScene(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant) {
+    if (!_spriteScenePipeline || _sceneLayerCounts.empty() || !BindPipeline(cmdBuf, *_spriteScenePipeline)) return;
+    BindDescriptorSet(cmdBuf, _uniformObject);
+
+    // switching layers is a push constant write, nothing is rebound
+    auto layerAddress = _sceneLayerBuffer->getDeviceAddress();
+    for (size_t i = 0; i < _sceneLayerCounts.size(); ++i) {
+        if (_sceneLayerCounts[i] == 0) continue;
+        auto layerConstant = pushConstant;
+        layerConstant.scene = layerAddress + i * sizeof(SpriteLayer);
+        PushConstants(cmdBuf, layerConstant);
+        cmdBuf.draw(6, _sceneLayerCounts[i], 0, 0);
+    }
+}
+
+PipelineHandle Renderer::GetDefaultPipeline() {
+    return _defaultPipeline;
+}
+
+bool Renderer::BindPipeline(vk::CommandBuffer& cmdBuf, PipelineHandle pipeline, PipelineFallback fallback) {
+    auto& registry = Context::GetInstance().pipelineRegistry;
+
+    // first use of a variant queues it on the compiler instead of stalling the frame
+    vk::Pipeline handle = fallback == PipelineFallback::Wait ? registry->Get(pipeline) : registry->TryGet(pipeline);
+    if (!handle) {
+        if (fallback == PipelineFallback::Skip) return false;
+        pipeline = _defaultPipeline;
+        handle = registry->Get(pipeline);
+    }
+
+    cmdBuf.bindPipeline(vk::PipelineBindPoint::eGraphics, handle);
+    _boundPipeline = pipeline;
+    return true;
+}
+
 void Renderer::SetUniformObject(const toy2d::UniformObject& ubo) {
-    bufferUniformData((void*)&ubo);
+    _uniformObject = ubo; // written into the uniform ring by each draw
+}
+
+void Renderer::BindDescriptorSet(vk::CommandBuffer& cmdBuf, const UniformObject& ubo) {
+    auto& registry = Context::GetInstance().pipelineRegistry;
+    auto program = registry->getProgram(_boundPipeline);
+    auto& bindings = registry->getShader(program).getBindings();
+    if (bindings.empty()) return; // e.g. untextured programs without uniforms
+
+    // one offset per dynamic binding, all of them read the same object
+    auto dynamicCount = std::ranges::count(bindings, vk::DescriptorType::eUniformBufferDynamic, &vk::DescriptorSetLayoutBinding::descriptorType);
+    std::vector<uint32_t> offsets(dynamicCount, dynamicCount > 0 ? _uniformRing->Push(ubo) : 0);
+    cmdBuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, registry->getLayout(_boundPipeline), 0, getDescriptorSets(program)[_curFrame], offsets);
+}
+
+void Renderer::PushConstants(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant) {
+    auto& registry = Context::GetInstance().pipelineRegistry;
+    auto range = registry->getShader(registry->getProgram(_boundPipeline)).getPushConstantRange();
+    if (!range.has_value()) return; // the shader reads no push constants
+
+    if (range->offset + range->size > sizeof(PushConstantObject)) {
+        throw std::runtime_error("Shader push constant block is larger than PushConstantObject.");
+    }
+    auto data = reinterpret_cast<const char*>(&pushConstant) + range->offset;
+    cmdBuf.pushConstants(registry->getLayout(_boundPipeline), range->stageFlags, range->offset, range->size, data);
 }
 
 void Renderer::SetTexture(std::string_view imagePath) {
+    requireNotRecording("SetTexture");
+    if (!_descriptorCache) {
+        _texture.reset(new Texture(imagePath));
+        return;
+    }
+
+    // cached sets still point at the old texture, drop them with it
+    Context::GetInstance().device.waitIdle();
     _texture.reset(new Texture(imagePath));
+    _descriptorCache->Clear();
+    _descriptorSets.clear(); // rebuilt on next bind
+}
+
+vk::DescriptorSet Renderer::AllocTransientDescriptorSet(vk::DescriptorSetLayout layout) {
+    return _frameDescriptorAllocators[_curFrame]->Allocate(layout);
+}
+
+DeletionQueue& Renderer::GetDeletionQueue() {
+    return _deletionQueue;
+}
+
+FrameTimer& Renderer::GetFrameTimer() {
+    return _frameTimer;
 }
 
 void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassFunc) {
+    Render([&](RenderGraph& graph, RenderGraph::ResourceHandle backbuffer) {
+        graph.AddPass("main", [&](RenderGraph::PassBuilder& builder) {
+            builder.Write(backbuffer, RenderGraph::Access::ColorAttachmentWrite);
+        }, [&](vk::CommandBuffer& cmdBuf) {
+            BeginBackbuffer(cmdBuf);
+            renderPassFunc(cmdBuf);
+            EndBackbuffer(cmdBuf);
+        });
+    });
+}
+
+void Renderer::Render(const std::function<void(RenderGraph&, RenderGraph::ResourceHandle)>& buildGraph) {
     auto& ctx = Context::GetInstance();
     auto& device = ctx.device;
     auto& swapchain = ctx.swapchain;
-    auto& renderProcess = ctx.renderProcess;
 
     /*
      * Render steps:
@@ -328,6 +455,9 @@ void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassF
      *   fences: submit -> signal cmdAvailable -> present -> wait cmdAvailable -> reset cmdAvailable
      */
 
+    // swap in shaders rebuilt in the background, before anything of this frame is recorded
+    if (ctx.shaderReloader) ctx.shaderReloader->Apply();
+
     auto& _cmdBuf = _cmdBufs[_curFrame];
     auto& _imageAvailable = _imageAvailableSems[_curFrame];
     auto& _cmdAvailable = _cmdAvailableFences[_curFrame];
@@ -338,6 +468,14 @@ void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassF
         throw std::runtime_error("Failed to wait for fence.");
     }
     device.resetFences(_cmdAvailable);
+    _uniformRing->BeginFrame(_curFrame);
+    _frameDescriptorAllocators[_curFrame]->Reset();
+    _deletionQueue.BeginFrame(_curFrame);
+    ctx.stagingRing->BeginFrame(_curFrame);
+    ctx.memoryManager->RefreshBudget();
+
+    // resolve present timing of earlier frames
+    _frameTimer.Poll();
 
     // acquire next image from swapchain
     auto result = device.acquireNextImageKHR(swapchain->swapchain, std::numeric_limits<uint64_t>::max(), _imageAvailable);
@@ -345,28 +483,33 @@ void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassF
         throw std::runtime_error("Failed to acquire next swapchain image.");
     }
     auto imageIndex = result.value;
+    _frameTimer.MarkAcquire();
 
     // reset command buffer
     _cmdBuf.reset();
 
+    // the frame is rebuilt every time, transient images stay alive while its shape does not change
+    _imageIndex = imageIndex;
+    auto& graph = *_frameGraphs[_curFrame];
+    graph.Reset();
+    auto backbuffer = graph.ImportImage("backbuffer", swapchain->images[imageIndex], swapchain->imageViews[imageIndex],
+                                        RenderGraph::Access::SwapchainAcquire, RenderGraph::Access::Present);
+    buildGraph(graph, backbuffer);
+    graph.Compile();
+
     // record command buffer
     vk::CommandBufferBeginInfo cmdBufBegin;
     cmdBufBegin.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit); // only used once
     _cmdBuf.begin(cmdBufBegin); {
-        vk::RenderPassBeginInfo renderPassBegin;
-
-        vk::Rect2D area({0, 0}, swapchain->info.imageExtent);
-        vk::ClearValue clearValue;
-        clearValue.color = Renderer::clearColor;
-        renderPassBegin
-        .setRenderPass(renderProcess->renderPass)
-        .setFramebuffer(swapchain->framebuffers[imageIndex])
-        .setRenderArea(area)
-        .setClearValues(clearValue);
-
-        _cmdBuf.beginRenderPass(renderPassBegin, {}); { // what is contents?
-            renderPassFunc(_cmdBuf);
-        } _cmdBuf.endRenderPass();
+        flushDynamicBuffers(_cmdBuf); // only the ranges written since the last frame
+        _recording = true;
+        try {
+            graph.Execute(_cmdBuf);
+        } catch (...) {
+            _recording = false;
+            throw;
+        }
+        _recording = false;
     } _cmdBuf.end();
 
     // !!! current frame <-> image index
@@ -381,6 +524,8 @@ void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassF
     .setSignalSemaphores(_imageRenderFinished)
     .setWaitDstStageMask(waitStage);
     ctx.graphicsQueue.submit(submit, _cmdAvailable);
+    ctx.stagingRing->EndFrame(_curFrame); // staging space used so far is free again once this frame's fence signals
+    _frameTimer.MarkSubmit();
 
     // present
     vk::PresentInfoKHR present;
@@ -388,12 +533,64 @@ void Renderer::Render(const std::function<void(vk::CommandBuffer&)>& renderPassF
     .setImageIndices(imageIndex)
     .setSwapchains(swapchain->swapchain)
     .setWaitSemaphores(_imageRenderFinished);
+    _frameTimer.AttachPresentInfo(present);
     if (ctx.presentQueue.presentKHR(present) != vk::Result::eSuccess) {
         throw std::runtime_error("Failed to present swapchain image.");
     }
+    _frameTimer.MarkPresent();
 
     // in flight
     _curFrame = (_curFrame + 1) % _maxFlightCount;
 }
 
+void Renderer::BeginBackbuffer(vk::CommandBuffer& cmdBuf) {
+    auto& ctx = Context::GetInstance();
+    vk::Rect2D area({0, 0}, ctx.swapchain->info.imageExtent);
+
+    vk::ClearValue clearValue;
+    clearValue.color = Renderer::clearColor;
+    if (ctx.renderProcess->dynamicRendering) {
+        vk::RenderingAttachmentInfo colorAttachment;
+        colorAttachment
+        .setImageView(ctx.swapchain->imageViews[_imageIndex])
+        .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+        .setLoadOp(vk::AttachmentLoadOp::eClear)
+        .setStoreOp(vk::AttachmentStoreOp::eStore)
+        .setClearValue(clearValue);
+
+        vk::RenderingInfo renderingInfo;
+        renderingInfo
+        .setRenderArea(area)
+        .setLayerCount(1)
+        .setColorAttachments(colorAttachment);
+        cmdBuf.beginRendering(renderingInfo);
+    } else {
+        vk::RenderPassBeginInfo renderPassBegin;
+        renderPassBegin
+        .setRenderPass(ctx.renderProcess->renderPass)
+        .setFramebuffer(ctx.swapchain->framebuffers[_imageIndex])
+        .setRenderArea(area)
+        .setClearValues(clearValue);
+        cmdBuf.beginRenderPass(renderPassBegin, {}); // what is contents?
+    }
+
+    // pipelines take viewport and scissor as dynamic state
+    vk::Viewport viewport(0, 0, static_cast<float>(area.extent.width), static_cast<float>(area.extent.height), 0, 1);
+    cmdBuf.setViewport(0, viewport);
+    cmdBuf.setScissor(0, area);
+}
+
+void Renderer::EndBackbuffer(vk::CommandBuffer& cmdBuf) {
+    if (Context::GetInstance().renderProcess->dynamicRendering) {
+        cmdBuf.endRendering();
+    } else {
+        cmdBuf.endRenderPass();
+    }
+}
+
+void Renderer::createRenderGraphs() {
+    _frameGraphs.resize(_maxFlightCount);
+    for (auto& graph : _frameGraphs) graph.reset(new RenderGraph);
+}
+
 }
@@ -12,14 +12,33 @@
 #include "buffer.hpp"
 #include "vertex.hpp"
 #include "uniform.hpp"
+#include "uniform_ring.hpp"
 #include "texture.hpp"
+#include "frame_timer.hpp"
+#include "descriptor_allocator.hpp"
+#include "pipeline_registry.hpp"
+#include "render_graph.hpp"
+#include "sprite_batch.hpp"
+#include "dynamic_buffer.hpp"
+#include "deletion_queue.hpp"
 
 #include <vector>
 #include <memory>
 #include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
 
 namespace toy2d {
 
+// what a draw does while its pipeline is still compiling in the background
+enum class PipelineFallback {
+    Wait,    // block until it is ready
+    Default, // draw with the default pipeline meanwhile
+    Skip,    // drop the draw
+};
+
 class Renderer {
 private:
     int _maxFlightCount;
@@ -31,25 +50,57 @@ private:
     std::vector<vk::Semaphore> _imageRenderFinishedSems;
     std::vector<vk::Fence> _cmdAvailableFences;
 
-    std::unique_ptr<Buffer> _hostVertexBuffer;
-    std::unique_ptr<Buffer> _deviceVertexBuffer;
-    std::unique_ptr<Buffer> _hostIndexBuffer;
-    std::unique_ptr<Buffer> _deviceIndexBuffer;
-    std::vector<std::unique_ptr<Buffer>> _uniformBuffers; // use coherent memory for volatile updates
+    DeletionQueue _deletionQueue; // flushed per frame slot, before anything below releases into it
+
+    std::unique_ptr<DynamicBuffer> _vertexBuffer;
+    std::unique_ptr<DynamicBuffer> _indexBuffer;
+    std::unique_ptr<UniformRing> _uniformRing; // per-frame slices bound with dynamic offsets
+    UniformObject _uniformObject { .opacity = 1.0f };
+
+    std::unique_ptr<DescriptorCache> _descriptorCache; // long-lived sets
+    std::vector<std::unique_ptr<DescriptorAllocator>> _frameDescriptorAllocators; // transient sets, reset every frame
+    std::unordered_map<ProgramHandle, std::vector<vk::DescriptorSet>> _descriptorSets; // set 0 of each program, per frame
+
+    PipelineHandle _defaultPipeline;
+    PipelineHandle _boundPipeline;
+    PipelineHandle _spritePipeline;
+
+    std::unique_ptr<DynamicBuffer> _spriteVertexBuffer;
+    std::unique_ptr<DynamicBuffer> _spriteIndexBuffer;
+    uint32_t _spriteIndexCount = 0;
+    QuantizationFrame _spriteFrame;
 
-    vk::DescriptorPool _descriptorPool;
-    std::vector<vk::DescriptorSet> _descriptorSets;
+    PipelineHandle _spritePullPipeline; // no vertex input, records are fetched by the vertex shader
+    std::unique_ptr<DynamicBuffer> _spriteRecordBuffer;
+    uint32_t _spriteRecordCount = 0;
+
+    std::optional<PipelineHandle> _spriteScenePipeline; // needs buffer device addresses
+    std::unique_ptr<DynamicBuffer> _sceneRecordBuffer;
+    std::unique_ptr<DynamicBuffer> _sceneLayerBuffer;   // SpriteLayer table pointing into the records
+    std::vector<uint32_t> _sceneLayerCounts;
 
     std::unique_ptr<Texture> _texture;
     vk::Sampler _sampler;
 
+    std::vector<std::unique_ptr<RenderGraph>> _frameGraphs; // one per frame in flight, transient images are not shared
+    uint32_t _imageIndex = 0;
+    bool _recording = false; // inside graph.Execute, dynamic buffers were flushed already
+
+    FrameTimer _frameTimer;
+
     static constexpr auto clearColor = vk::ClearColorValue(std::array<float,4> {0.1f, 0.1f, 0.1f, 1.0f});
 
 public:
     Renderer(int maxFlightCount = 2);
     ~Renderer();
 
-    void Render(const std::function<void(vk::CommandBuffer& cmdBuf)>& renderPassFunc);
+    void Render(const std::function<void(vk::CommandBuffer& cmdBuf)>& renderPassFunc); // one pass drawing to the backbuffer
+    void Render(const std::function<void(RenderGraph& graph, RenderGraph::ResourceHandle backbuffer)>& buildGraph);
+    // Set* and SetTexture throw inside pass callbacks, their writes reach the GPU before the passes are recorded
+
+    // inside a pass writing the backbuffer as ColorAttachmentWrite
+    void BeginBackbuffer(vk::CommandBuffer& cmdBuf);
+    void EndBackbuffer(vk::CommandBuffer& cmdBuf);
 
     void InitTriangle();
     void SetTriangle(const std::array<vec2, 3>& vertices);
@@ -58,27 +109,48 @@ public:
     void InitRectangle();
     void SetRectangle(const std::array<vec2, 4>& vertices, const std::array<uint32_t, 6>& indices);
     void DrawRectangle();
+    void DrawRectangle(const PushConstantObject& pushConstant);
+    void DrawRectangle(const PushConstantObject& pushConstant, PipelineHandle pipeline, PipelineFallback fallback = PipelineFallback::Wait);
+    void DrawRectangle(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant, PipelineHandle pipeline,
+                       PipelineFallback fallback = PipelineFallback::Wait); // inside Render()
+
+    void SetSprites(const SpriteBatch& batch);
+    void DrawSprites(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant); // inside Render()
+    void SetSpriteRecords(const SpriteBatch& batch);
+    uint32_t GetSpriteRecordCount();
+    void DrawSpriteRecords(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant,
+                           uint32_t first = 0, uint32_t count = UINT32_MAX); // inside Render(), a range of the records
+    bool SetSpriteScene(std::span<const SpriteBatch> layers); // false without buffer device address support
+    void DrawSpriteScene(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant); // inside Render(), layers in order
+
+    PipelineHandle GetDefaultPipeline();
+    bool BindPipeline(vk::CommandBuffer& cmdBuf, PipelineHandle pipeline, PipelineFallback fallback = PipelineFallback::Wait); // false if nothing was bound
 
     void SetUniformObject(const UniformObject& ubo);
+    void PushConstants(vk::CommandBuffer& cmdBuf, const PushConstantObject& pushConstant);
+    void BindDescriptorSet(vk::CommandBuffer& cmdBuf, const UniformObject& ubo);
+    vk::DescriptorSet AllocTransientDescriptorSet(vk::DescriptorSetLayout layout); // valid until this frame slot comes round again
+    DeletionQueue& GetDeletionQueue(); // for resources frames in flight may still use
     void SetTexture(std::string_view imagePath);
 
+    FrameTimer& GetFrameTimer();
+
 private:
     void allocCommandBuffer();
     void createSemaphores();
     void createFences();
 
-    void createVertexBuffer(size_t size);
-    void bufferVertexData(void* data);
-    void createIndexBuffer(size_t size);
-    void bufferIndexData(void* data);
+    void createDynamicBuffers();
+    void flushDynamicBuffers(vk::CommandBuffer& cmdBuf);
+    void requireNotRecording(std::string_view caller);
 
-    void createUniformBuffer(size_t size);
-    void bufferUniformData(void* data);
-    void createDescriptorPool();
-    void allocDescriptorSets();
-    void updateDescriptorSets();
+    void createUniformRing(size_t size);
+    void createDescriptorAllocators();
+    const std::vector<vk::DescriptorSet>& getDescriptorSets(ProgramHandle program);
 
     void createSampler();
+
+    void createRenderGraphs();
 };
 
 }
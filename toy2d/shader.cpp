@@ -8,57 +8,65 @@
 #include "shader.hpp"
 
 #include "context.hpp"
+#include "uniform.hpp"
 
-namespace toy2d {
-
-std::unique_ptr<Shader> Shader::_instance = nullptr;
+#include <algorithm>
+#include <string>
+#include <cstdint>
 
-void Shader::Init(const std::string& vertexSource, const std::string& fragmentSource) {
-    _instance.reset(new Shader(vertexSource, fragmentSource));
-}
-
-void Shader::Quit() {
-    _instance.reset();
-}
+namespace toy2d {
 
-Shader& Shader::GetInstance() {
-    return *_instance;
+std::unique_ptr<Shader> Shader::Load(std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode) {
+    return std::unique_ptr<Shader>(new Shader(vertexCode, fragmentCode));
 }
 
-Shader::Shader(const std::string& vertexSource, const std::string& fragmentSource) {
-    vk::ShaderModuleCreateInfo createInfo;
+Shader::Shader(std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode) {
+    vertexModule = createModule(vertexCode, _vertexReflection);
+    fragmentModule = createModule(fragmentCode, _fragmentReflection);
 
-    createInfo
-    .setCodeSize(vertexSource.size())
-    .setPCode(reinterpret_cast<const uint32_t*>(vertexSource.data()));
-    vertexModule = Context::GetInstance().device.createShaderModule(createInfo);
-
-    createInfo
-    .setCodeSize(fragmentSource.size())
-    .setPCode(reinterpret_cast<const uint32_t*>(fragmentSource.data()));
-    fragmentModule = Context::GetInstance().device.createShaderModule(createInfo);
+    if (_vertexReflection.stage != vk::ShaderStageFlagBits::eVertex ||
+        _fragmentReflection.stage != vk::ShaderStageFlagBits::eFragment) {
+        throw std::runtime_error("Shader stages do not match their SPIR-V entry points.");
+    }
 
     initStages();
     initDescriptorSetLayout();
+    initPushConstantRange();
+    initPipelineLayout();
+    initVertexInput();
 }
 
 Shader::~Shader() noexcept {
     auto& device = Context::GetInstance().device;
-    device.destroyDescriptorSetLayout(_descriptorSetLayout);
     device.destroyShaderModule(vertexModule);
     device.destroyShaderModule(fragmentModule);
 }
 
+vk::ShaderModule Shader::createModule(std::span<const std::byte> code, ShaderReflection& reflection) {
+    // mapped files are page aligned, so the words can be read in place
+    if (code.size() % sizeof(uint32_t) != 0 || reinterpret_cast<uintptr_t>(code.data()) % alignof(uint32_t) != 0) {
+        throw std::runtime_error("SPIR-V code must be a 4 byte aligned array of words.");
+    }
+    std::span<const uint32_t> words(reinterpret_cast<const uint32_t*>(code.data()), code.size() / sizeof(uint32_t));
+    reflection = ReflectSpirv(words);
+
+    vk::ShaderModuleCreateInfo createInfo;
+    createInfo
+    .setCodeSize(code.size())
+    .setPCode(words.data());
+    return Context::GetInstance().device.createShaderModule(createInfo);
+}
+
 void Shader::initStages() {
     _stages.resize(2);
     _stages[0]
     .setStage(vk::ShaderStageFlagBits::eVertex)
     .setModule(vertexModule)
-    .setPName("main");
+    .setPName(_vertexReflection.entryPoint.c_str());
     _stages[1]
     .setStage(vk::ShaderStageFlagBits::eFragment)
     .setModule(fragmentModule)
-    .setPName("main");
+    .setPName(_fragmentReflection.entryPoint.c_str());
 }
 
 std::vector<vk::PipelineShaderStageCreateInfo> Shader::getStages() {
@@ -66,26 +74,111 @@ std::vector<vk::PipelineShaderStageCreateInfo> Shader::getStages() {
 }
 
 void Shader::initDescriptorSetLayout() {
-    vk::DescriptorSetLayoutCreateInfo createInfo;
+    // merge the bindings of both stages
+    for (const auto* reflection : { &_vertexReflection, &_fragmentReflection }) {
+        for (const auto& binding : reflection->bindings) {
+            // the renderer binds set 0 only
+            if (binding.set != 0) {
+                throw std::runtime_error("Descriptor '" + binding.name + "' is in set " + std::to_string(binding.set) + ", only set 0 is supported.");
+            }
+
+            // only UniformObject blocks come from the per-frame ring, any other uniform block stays a plain uniform buffer
+            auto type = binding.type;
+            if (type == vk::DescriptorType::eUniformBuffer && binding.blockName == UniformObject::blockName) {
+                if (binding.size > sizeof(UniformObject)) {
+                    throw std::runtime_error("Uniform block '" + binding.name + "' is larger than UniformObject.");
+                }
+                type = vk::DescriptorType::eUniformBufferDynamic;
+            }
+
+            if (_setBindings.size() <= binding.set) _setBindings.resize(binding.set + 1);
+            auto& bindings = _setBindings[binding.set];
+            auto it = std::ranges::find(bindings, binding.binding, &vk::DescriptorSetLayoutBinding::binding);
+            if (it == bindings.end()) {
+                bindings.emplace_back(binding.binding, type, binding.count, reflection->stage);
+                continue;
+            }
+            if (it->descriptorType != type) {
+                throw std::runtime_error("Descriptor '" + binding.name + "' has different types in vertex and fragment shaders.");
+            }
+            it->stageFlags |= reflection->stage;
+            it->descriptorCount = std::max(it->descriptorCount, binding.count);
+        }
+    }
+
+    // set 0 gets a layout even without bindings
+    auto& layoutCache = Context::GetInstance().layoutCache;
+    if (_setBindings.empty()) _setBindings.resize(1);
+    for (const auto& bindings : _setBindings) {
+        _descriptorSetLayouts.push_back(layoutCache->GetDescriptorSetLayout(bindings)); // owned by the cache
+    }
+}
 
-    std::vector<vk::DescriptorSetLayoutBinding> bindings(2);
-    bindings[0]
-    .setBinding(0)
-    .setDescriptorType(vk::DescriptorType::eUniformBuffer)
-    .setDescriptorCount(1)
-    .setStageFlags(vk::ShaderStageFlagBits::eFragment);
-    bindings[1]
-    .setBinding(1)
-    .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-    .setDescriptorCount(1)
-    .setStageFlags(vk::ShaderStageFlagBits::eFragment);
+void Shader::initPushConstantRange() {
+    for (const auto* reflection : { &_vertexReflection, &_fragmentReflection }) {
+        if (!reflection->pushConstantRange.has_value()) continue;
+        auto range = reflection->pushConstantRange.value();
+        if (!_pushConstantRange.has_value()) {
+            _pushConstantRange = range;
+            continue;
+        }
+
+        // one range visible to every stage that declares the block
+        auto begin = std::min(_pushConstantRange->offset, range.offset);
+        auto end = std::max(_pushConstantRange->offset + _pushConstantRange->size, range.offset + range.size);
+        _pushConstantRange
+        ->setStageFlags(_pushConstantRange->stageFlags | range.stageFlags)
+        .setOffset(begin)
+        .setSize(end - begin);
+    }
+}
 
-    createInfo.setBindings(bindings);
-    _descriptorSetLayout = Context::GetInstance().device.createDescriptorSetLayout(createInfo);
+void Shader::initPipelineLayout() {
+    std::vector<vk::PushConstantRange> pushConstantRanges;
+    if (_pushConstantRange.has_value()) pushConstantRanges.push_back(*_pushConstantRange);
+
+    // shared with every program of the same interface
+    _pipelineLayout = Context::GetInstance().layoutCache->GetPipelineLayout(_descriptorSetLayouts, pushConstantRanges);
+}
+
+void Shader::initVertexInput() {
+    // tightly packed, single interleaved binding in location order
+    uint32_t offset = 0;
+    for (const auto& input : _vertexReflection.inputs) {
+        _vertexAttributes.emplace_back(input.location, 0, input.format, offset);
+        offset += input.size;
+    }
+    if (offset == 0) return; // no fixed-function vertex input
+
+    _vertexBindings.emplace_back(0, offset, vk::VertexInputRate::eVertex);
 }
 
 vk::DescriptorSetLayout Shader::getDescriptorSetLayout() {
-    return _descriptorSetLayout;
+    return _descriptorSetLayouts[0];
+}
+
+const std::vector<vk::DescriptorSetLayout>& Shader::getDescriptorSetLayouts() {
+    return _descriptorSetLayouts;
+}
+
+const std::vector<vk::DescriptorSetLayoutBinding>& Shader::getBindings(uint32_t set) {
+    return _setBindings.at(set);
+}
+
+std::optional<vk::PushConstantRange> Shader::getPushConstantRange() {
+    return _pushConstantRange;
+}
+
+vk::PipelineLayout Shader::getPipelineLayout() {
+    return _pipelineLayout;
+}
+
+const std::vector<vk::VertexInputAttributeDescription>& Shader::getVertexAttributes() {
+    return _vertexAttributes;
+}
+
+const std::vector<vk::VertexInputBindingDescription>& Shader::getVertexBindings() {
+    return _vertexBindings;
 }
 
 }
\ No newline at end of file
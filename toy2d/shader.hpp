@@ -9,8 +9,14 @@
 
 #include "vulkan/vulkan.hpp"
 
+#include "spirv_reflect.hpp"
+
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
+#include <cstddef>
 
 namespace toy2d {
 
@@ -20,25 +26,41 @@ public:
     vk::ShaderModule fragmentModule;
 
 private:
-    static std::unique_ptr<Shader> _instance;
     std::vector<vk::PipelineShaderStageCreateInfo> _stages;
-    vk::DescriptorSetLayout _descriptorSetLayout;
 
-public:
-    static void Init(const std::string& vertexSource, const std::string& fragmentSource);
-    static void Quit();
+    // everything below is derived from the SPIR-V itself
+    ShaderReflection _vertexReflection;
+    ShaderReflection _fragmentReflection;
+    std::vector<std::vector<vk::DescriptorSetLayoutBinding>> _setBindings; // indexed by set
+    std::vector<vk::DescriptorSetLayout> _descriptorSetLayouts;
+    std::optional<vk::PushConstantRange> _pushConstantRange;
+    vk::PipelineLayout _pipelineLayout; // owned by the layout cache
+    std::vector<vk::VertexInputAttributeDescription> _vertexAttributes;
+    std::vector<vk::VertexInputBindingDescription> _vertexBindings;
 
-    static Shader& GetInstance();
+public:
+    // programs are owned by the PipelineRegistry, reloaded ones may be built on a worker thread
+    static std::unique_ptr<Shader> Load(std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode);
 
     std::vector<vk::PipelineShaderStageCreateInfo> getStages();
-    vk::DescriptorSetLayout getDescriptorSetLayout();
+    vk::DescriptorSetLayout getDescriptorSetLayout(); // set 0
+    const std::vector<vk::DescriptorSetLayout>& getDescriptorSetLayouts();
+    const std::vector<vk::DescriptorSetLayoutBinding>& getBindings(uint32_t set = 0);
+    std::optional<vk::PushConstantRange> getPushConstantRange();
+    vk::PipelineLayout getPipelineLayout();
+    const std::vector<vk::VertexInputAttributeDescription>& getVertexAttributes();
+    const std::vector<vk::VertexInputBindingDescription>& getVertexBindings();
 
     ~Shader();
 
 private:
-    Shader(const std::string& vertexSource, const std::string& fragmentSource);
+    Shader(std::span<const std::byte> vertexCode, std::span<const std::byte> fragmentCode);
+    vk::ShaderModule createModule(std::span<const std::byte> code, ShaderReflection& reflection);
     void initStages();
     void initDescriptorSetLayout();
+    void initPushConstantRange();
+    void initPipelineLayout();
+    void initVertexInput();
 };
 
 }
@@ -0,0 +1,239 @@
+/**
+  * @file   shader_reloader.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "shader_reloader.hpp"
+
+#include "context.hpp"
+#include "shader.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <set>
+#include <utility>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifndef TOY2D_GLSLC_PROGRAM
+#define TOY2D_GLSLC_PROGRAM "glslc"
+#endif
+
+namespace toy2d {
+
+namespace {
+
+constexpr auto pollInterval = std::chrono::milliseconds(250);
+constexpr auto settleDelay = std::chrono::milliseconds(50); // editors often write a file in several steps
+
+std::filesystem::file_time_type lastWriteTime(const std::filesystem::path& path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+}
+
+ShaderReloader::ShaderReloader(const std::vector<WatchedProgram>& programs) : _programs(programs) {
+    for (const auto& program : _programs) {
+        for (const auto& path : { program.vertexPath, program.fragmentPath }) {
+            if (std::ranges::find(_sources, std::filesystem::path(path), &Source::path) != _sources.end()) continue;
+            Source source;
+            source.path = path;
+            source.binary = path + ".spv";
+            source.lastWrite = lastWriteTime(source.path);
+            _sources.push_back(source);
+        }
+    }
+    openWatches();
+    _worker = std::jthread([this](std::stop_token stop) { watch(stop); });
+}
+
+ShaderReloader::~ShaderReloader() {
+    _worker.request_stop();
+    if (_worker.joinable()) _worker.join();
+    closeWatches();
+
+    for (auto& rebuilt : _pending) discard(rebuilt);
+}
+
+bool ShaderReloader::Apply() {
+    // also keeps the worker from reading a program while it is replaced
+    std::lock_guard lock(_mutex);
+    if (_pending.empty()) return false;
+
+    // the old pipelines and modules may still be referenced by frames in flight
+    auto& ctx = Context::GetInstance();
+    ctx.device.waitIdle();
+    for (auto& rebuilt : _pending) {
+        ctx.pipelineRegistry->ReplaceProgram(rebuilt.program, std::move(rebuilt.shader), rebuilt.pipelines);
+    }
+    _pending.clear();
+    return true;
+}
+
+void ShaderReloader::watch(std::stop_token stop) {
+    while (!stop.stop_requested()) {
+        if (!waitForChange(stop)) continue;
+        std::this_thread::sleep_for(settleDelay);
+
+        // recompile only what changed, a failed compile keeps the current pipelines
+        std::vector<std::filesystem::path> changed;
+        bool compiled = true;
+        for (auto& source : _sources) {
+            auto time = lastWriteTime(source.path);
+            if (time == source.lastWrite) continue;
+            source.lastWrite = time;
+            changed.push_back(source.path);
+            compiled = compile(source) && compiled;
+        }
+        if (!compiled) continue;
+
+        // rebuild every program using a changed source, and nothing else
+        for (const auto& program : _programs) {
+            if (std::ranges::find(changed, std::filesystem::path(program.vertexPath)) == changed.end() &&
+                std::ranges::find(changed, std::filesystem::path(program.fragmentPath)) == changed.end()) continue;
+            try {
+                rebuild(program);
+            } catch (const std::exception& e) {
+                std::cerr << "Shader reload failed: " << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+#if defined(__linux__)
+void ShaderReloader::openWatches() {
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotify < 0) return;
+
+    // watch the directories, editors tend to replace files instead of writing them in place
+    std::set<std::filesystem::path> directories;
+    for (const auto& source : _sources) directories.insert(source.path.parent_path());
+    for (const auto& directory : directories) {
+        auto name = directory.empty() ? std::string(".") : directory.string();
+        inotify_add_watch(_inotify, name.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    }
+}
+
+void ShaderReloader::closeWatches() {
+    if (_inotify >= 0) ::close(_inotify);
+    _inotify = -1;
+}
+
+bool ShaderReloader::waitForChange(std::stop_token stop) {
+    if (_inotify < 0) {
+        std::this_thread::sleep_for(pollInterval);
+        return pollChanges();
+    }
+
+    // events queue up on the fd while the previous change is compiled, nothing is missed in between
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    while (!changed && !stop.stop_requested()) {
+        pollfd pfd { _inotify, POLLIN, 0 };
+        if (::poll(&pfd, 1, static_cast<int>(pollInterval.count())) <= 0) continue;
+
+        auto length = ::read(_inotify, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;) {
+            auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            if (event->len == 0) continue;
+            for (const auto& source : _sources) {
+                if (source.path.filename() == event->name) changed = true;
+            }
+        }
+    }
+    return changed;
+}
+#else
+void ShaderReloader::openWatches() {}
+
+void ShaderReloader::closeWatches() {}
+
+bool ShaderReloader::waitForChange(std::stop_token stop) {
+    while (!stop.stop_requested()) {
+        if (pollChanges()) return true;
+        std::this_thread::sleep_for(pollInterval);
+    }
+    return false;
+}
+#endif
+
+bool ShaderReloader::pollChanges() {
+    for (const auto& source : _sources) {
+        if (lastWriteTime(source.path) != source.lastWrite) return true;
+    }
+    return false;
+}
+
+bool ShaderReloader::compile(const Source& source) {
+    // same compiler the CompileShaders target uses
+    auto command = std::format("\"{}\" \"{}\" -o \"{}\"", TOY2D_GLSLC_PROGRAM, source.path.string(), source.binary.string());
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Failed to compile shader: " << source.path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ShaderReloader::rebuild(const WatchedProgram& watched) {
+    auto& registry = Context::GetInstance().pipelineRegistry;
+    Rebuilt rebuilt;
+    rebuilt.program = watched.program;
+    MappedFile vertexCode(watched.vertexPath + ".spv", MappedFile::Hint::WillNeed);
+    MappedFile fragmentCode(watched.fragmentPath + ".spv", MappedFile::Hint::WillNeed);
+    rebuilt.shader = Shader::Load(vertexCode.data(), fragmentCode.data());
+
+    // descriptor sets and push constants are shared with the running pipelines
+    bool compatible;
+    {
+        std::lock_guard lock(_mutex);
+        auto& current = registry->getShader(watched.program);
+        compatible = rebuilt.shader->getPipelineLayout() == current.getPipelineLayout() &&
+                     rebuilt.shader->getVertexAttributes() == current.getVertexAttributes() &&
+                     rebuilt.shader->getVertexBindings() == current.getVertexBindings();
+    }
+    if (!compatible) {
+        std::cerr << "Shader reload rejected: resource interface changed, restart to apply." << std::endl;
+        return;
+    }
+
+    // only the pipelines created from this program so far, the rest are built on first use
+    try {
+        for (const auto& [handle, key] : registry->getPipelines(watched.program)) {
+            rebuilt.pipelines.emplace_back(handle, PipelineRegistry::CreatePipeline(*rebuilt.shader, key));
+        }
+    } catch (...) {
+        discard(rebuilt);
+        throw;
+    }
+
+    std::lock_guard lock(_mutex);
+    auto it = std::ranges::find(_pending, watched.program, &Rebuilt::program);
+    if (it == _pending.end()) {
+        _pending.push_back(std::move(rebuilt));
+        return;
+    }
+    discard(*it); // superseded before it was applied
+    *it = std::move(rebuilt);
+}
+
+void ShaderReloader::discard(Rebuilt& rebuilt) {
+    auto& device = Context::GetInstance().device;
+    for (const auto& [handle, pipeline] : rebuilt.pipelines) device.destroyPipeline(pipeline);
+    rebuilt.pipelines.clear();
+    rebuilt.shader.reset();
+}
+
+}
@@ -0,0 +1,75 @@
+/**
+  * @file   shader_reloader.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "pipeline_registry.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace toy2d {
+
+class Shader;
+
+// watches GLSL sources, recompiles them and rebuilds the affected pipelines off the render thread
+class ShaderReloader {
+public:
+    struct WatchedProgram {
+        ProgramHandle program;
+        std::string vertexPath;   // GLSL sources, compiled next to themselves as <path>.spv
+        std::string fragmentPath;
+    };
+
+    struct Source {
+        std::filesystem::path path;   // GLSL source, e.g. shader/texture.frag
+        std::filesystem::path binary; // compiled next to it, e.g. shader/texture.frag.spv
+        std::filesystem::file_time_type lastWrite;
+    };
+
+private:
+    struct Rebuilt {
+        ProgramHandle program;
+        std::unique_ptr<Shader> shader;
+        std::vector<std::pair<PipelineHandle, vk::Pipeline>> pipelines;
+    };
+
+    std::vector<WatchedProgram> _programs;
+    std::vector<Source> _sources;
+    int _inotify = -1; // watches the source directories for the whole lifetime, -1 falls back to polling
+
+    // built by the worker, swapped in by Apply()
+    std::mutex _mutex;
+    std::vector<Rebuilt> _pending;
+
+    std::jthread _worker; // declared last, joined before the members above go away
+
+public:
+    ShaderReloader(const std::vector<WatchedProgram>& programs);
+    ~ShaderReloader();
+
+    // call at a frame boundary on the render thread, returns true if anything was swapped in
+    bool Apply();
+
+private:
+    void watch(std::stop_token stop);
+    void openWatches();
+    void closeWatches();
+    bool waitForChange(std::stop_token stop);
+    bool pollChanges();
+    bool compile(const Source& source);
+    void rebuild(const WatchedProgram& watched);
+    void discard(Rebuilt& rebuilt);
+};
+
+}
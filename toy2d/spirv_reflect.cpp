@@ -0,0 +1,534 @@
+/**
+  * @file   spirv_reflect.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief
+  */
+
+#include "spirv_reflect.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace toy2d {
+
+namespace {
+
+// the subset of the SPIR-V grammar needed for interface reflection
+namespace spv {
+
+constexpr uint32_t MagicNumber = 0x07230203;
+constexpr size_t HeaderWords = 5;
+
+enum Op : uint32_t {
+    OpName = 5,
+    OpEntryPoint = 15,
+    OpTypeVoid = 19,
+    OpTypeBool = 20,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpSpecConstant = 50,
+    OpFunctionCall = 57,
+    OpVariable = 59,
+    OpImageTexelPointer = 60,
+    OpLoad = 61,
+    OpStore = 62,
+    OpCopyMemory = 63,
+    OpCopyMemorySized = 64,
+    OpAccessChain = 65,
+    OpInBoundsAccessChain = 66,
+    OpPtrAccessChain = 67,
+    OpArrayLength = 68,
+    OpInBoundsPtrAccessChain = 70,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+    OpCopyObject = 83,
+    OpAtomicLoad = 227,
+    OpAtomicStore = 228,
+    OpAtomicXor = 242,
+};
+
+enum Decoration : uint32_t {
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationRowMajor = 4,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationLocation = 30,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+};
+
+enum StorageClass : uint32_t {
+    StorageClassUniformConstant = 0,
+    StorageClassInput = 1,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+};
+
+enum ExecutionModel : uint32_t {
+    ExecutionModelVertex = 0,
+    ExecutionModelTessellationControl = 1,
+    ExecutionModelTessellationEvaluation = 2,
+    ExecutionModelGeometry = 3,
+    ExecutionModelFragment = 4,
+    ExecutionModelGLCompute = 5,
+};
+
+enum Dim : uint32_t {
+    DimBuffer = 5,
+    DimSubpassData = 6,
+};
+
+}
+
+struct Type {
+    uint32_t opcode = 0;
+    uint32_t width = 0;         // int, float
+    bool isSigned = false;      // int
+    uint32_t element = 0;       // vector component, matrix column, array element, pointee
+    uint32_t count = 0;         // vector components, matrix columns, array length
+    bool specializedLength = false; // array length computed by a spec constant op, unknown until specialization
+    uint32_t storageClass = 0;  // pointer
+    uint32_t dim = 0;           // image
+    uint32_t sampled = 0;       // image, 1 = sampled, 2 = storage
+    std::vector<uint32_t> members;
+};
+
+struct MemberDecorations {
+    uint32_t offset = 0;
+    uint32_t matrixStride = 0;
+    bool rowMajor = false;
+    bool builtIn = false;
+};
+
+struct Decorations {
+    std::optional<uint32_t> set;
+    std::optional<uint32_t> binding;
+    std::optional<uint32_t> location;
+    std::optional<uint32_t> arrayStride;
+    bool block = false;
+    bool bufferBlock = false;
+    bool builtIn = false;
+    std::unordered_map<uint32_t, MemberDecorations> members;
+};
+
+struct Variable {
+    uint32_t id;
+    uint32_t type; // pointer type
+    uint32_t storageClass;
+};
+
+class Module {
+private:
+    std::span<const uint32_t> _code;
+    std::unordered_map<uint32_t, Type> _types;
+    std::unordered_map<uint32_t, uint32_t> _constants;
+    std::unordered_map<uint32_t, Decorations> _decorations;
+    std::unordered_map<uint32_t, std::string> _names;
+    std::vector<Variable> _variables;
+    std::optional<uint32_t> _executionModel;
+    std::string _entryPoint;
+    std::unordered_set<uint32_t> _interface;  // of the entry point, every used global from SPIR-V 1.4 on, inputs and outputs before
+    std::unordered_set<uint32_t> _referenced; // pointer operands of instructions in function bodies
+
+public:
+    explicit Module(std::span<const uint32_t> code) : _code(code) {}
+
+    ShaderReflection Reflect() {
+        parse();
+
+        ShaderReflection reflection;
+        reflection.stage = stageOf(_executionModel.value());
+        reflection.entryPoint = _entryPoint;
+
+        for (const auto& variable : _variables) {
+            // declared but unused resources would need descriptors the renderer may not have
+            if (!_interface.contains(variable.id) && !_referenced.contains(variable.id)) continue;
+            switch (variable.storageClass) {
+            case spv::StorageClassUniformConstant:
+            case spv::StorageClassUniform:
+            case spv::StorageClassStorageBuffer:
+                reflectBinding(variable, reflection);
+                break;
+            case spv::StorageClassPushConstant:
+                reflectPushConstant(variable, reflection);
+                break;
+            case spv::StorageClassInput:
+                if (reflection.stage == vk::ShaderStageFlagBits::eVertex) reflectInput(variable, reflection);
+                break;
+            default:
+                break;
+            }
+        }
+
+        std::ranges::sort(reflection.bindings, [](const auto& a, const auto& b) {
+            return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+        });
+        std::ranges::sort(reflection.inputs, {}, &ShaderReflection::Input::location);
+        return reflection;
+    }
+
+private:
+    void parse() {
+        if (_code.size() < spv::HeaderWords || _code[0] != spv::MagicNumber) {
+            throw std::runtime_error("Invalid SPIR-V module.");
+        }
+
+        for (size_t i = spv::HeaderWords; i < _code.size();) {
+            auto opcode = _code[i] & 0xffff;
+            auto wordCount = _code[i] >> 16;
+            if (wordCount == 0 || i + wordCount > _code.size()) {
+                throw std::runtime_error("Malformed SPIR-V instruction.");
+            }
+            parseInstruction(opcode, _code.subspan(i, wordCount));
+            i += wordCount;
+        }
+
+        if (!_executionModel.has_value()) throw std::runtime_error("SPIR-V module has no entry point.");
+    }
+
+    void parseInstruction(uint32_t opcode, std::span<const uint32_t> words) {
+        switch (opcode) {
+        case spv::OpName:
+            _names[words[1]] = readString(words.subspan(2));
+            break;
+        case spv::OpEntryPoint: {
+            if (_executionModel.has_value()) break; // only the first entry point is reflected
+            _executionModel = words[1];
+            _entryPoint = readString(words.subspan(3));
+            // the interface ids follow the nul terminated name
+            auto interfaceBegin = 3 + _entryPoint.size() / sizeof(uint32_t) + 1;
+            for (auto i = interfaceBegin; i < words.size(); ++i) _interface.insert(words[i]);
+            break;
+        }
+        case spv::OpTypeVoid:
+        case spv::OpTypeBool:
+        case spv::OpTypeSampler:
+            _types[words[1]].opcode = opcode;
+            break;
+        case spv::OpTypeInt:
+            _types[words[1]] = { .opcode = opcode, .width = words[2], .isSigned = words[3] != 0 };
+            break;
+        case spv::OpTypeFloat:
+            _types[words[1]] = { .opcode = opcode, .width = words[2], .isSigned = true };
+            break;
+        case spv::OpTypeVector:
+        case spv::OpTypeMatrix:
+            _types[words[1]] = { .opcode = opcode, .element = words[2], .count = words[3] };
+            break;
+        case spv::OpTypeImage:
+            _types[words[1]] = { .opcode = opcode, .element = words[2], .dim = words[3], .sampled = words[7] };
+            break;
+        case spv::OpTypeSampledImage:
+        case spv::OpTypeRuntimeArray:
+            _types[words[1]] = { .opcode = opcode, .element = words[2] };
+            break;
+        case spv::OpTypeArray: {
+            auto length = _constants.find(words[3]);
+            _types[words[1]] = {
+                .opcode = opcode,
+                .element = words[2],
+                .count = length == _constants.end() ? 0 : length->second,
+                .specializedLength = length == _constants.end(),
+            };
+            break;
+        }
+        case spv::OpTypeStruct:
+            _types[words[1]] = { .opcode = opcode, .members = { words.begin() + 2, words.end() } };
+            break;
+        case spv::OpTypePointer:
+            _types[words[1]] = { .opcode = opcode, .element = words[3], .storageClass = words[2] };
+            break;
+        case spv::OpConstant:
+        case spv::OpSpecConstant:
+            _constants[words[2]] = words[3]; // low word is enough for array lengths
+            break;
+        case spv::OpVariable:
+            _variables.push_back({ .id = words[2], .type = words[1], .storageClass = words[3] });
+            break;
+        case spv::OpDecorate:
+            decorate(_decorations[words[1]], words[2], words.subspan(3));
+            break;
+        case spv::OpMemberDecorate:
+            decorateMember(_decorations[words[1]].members[words[2]], words[3], words.subspan(4));
+            break;
+        case spv::OpStore:
+        case spv::OpAtomicStore:
+            _referenced.insert(words[1]);
+            break;
+        case spv::OpCopyMemory:
+        case spv::OpCopyMemorySized:
+            _referenced.insert(words[1]);
+            _referenced.insert(words[2]);
+            break;
+        case spv::OpLoad:
+        case spv::OpImageTexelPointer:
+        case spv::OpAccessChain:
+        case spv::OpInBoundsAccessChain:
+        case spv::OpPtrAccessChain:
+        case spv::OpInBoundsPtrAccessChain:
+        case spv::OpArrayLength:
+        case spv::OpCopyObject:
+            _referenced.insert(words[3]);
+            break;
+        case spv::OpFunctionCall:
+            // globals passed as pointer arguments
+            for (size_t i = 4; i < words.size(); ++i) _referenced.insert(words[i]);
+            break;
+        default:
+            // OpAtomicLoad ... OpAtomicXor, the pointer is the first operand
+            if (opcode >= spv::OpAtomicLoad && opcode <= spv::OpAtomicXor) _referenced.insert(words[3]);
+            break;
+        }
+    }
+
+    static void decorate(Decorations& decorations, uint32_t decoration, std::span<const uint32_t> literals) {
+        switch (decoration) {
+        case spv::DecorationBlock: decorations.block = true; break;
+        case spv::DecorationBufferBlock: decorations.bufferBlock = true; break;
+        case spv::DecorationBuiltIn: decorations.builtIn = true; break;
+        case spv::DecorationArrayStride: decorations.arrayStride = literals[0]; break;
+        case spv::DecorationLocation: decorations.location = literals[0]; break;
+        case spv::DecorationBinding: decorations.binding = literals[0]; break;
+        case spv::DecorationDescriptorSet: decorations.set = literals[0]; break;
+        default: break;
+        }
+    }
+
+    static void decorateMember(MemberDecorations& decorations, uint32_t decoration, std::span<const uint32_t> literals) {
+        switch (decoration) {
+        case spv::DecorationOffset: decorations.offset = literals[0]; break;
+        case spv::DecorationMatrixStride: decorations.matrixStride = literals[0]; break;
+        case spv::DecorationRowMajor: decorations.rowMajor = true; break;
+        case spv::DecorationBuiltIn: decorations.builtIn = true; break;
+        default: break;
+        }
+    }
+
+    static std::string readString(std::span<const uint32_t> words) {
+        auto chars = reinterpret_cast<const char*>(words.data());
+        return std::string(chars, std::find(chars, chars + words.size() * sizeof(uint32_t), '\0'));
+    }
+
+    static vk::ShaderStageFlagBits stageOf(uint32_t executionModel) {
+        switch (executionModel) {
+        case spv::ExecutionModelVertex: return vk::ShaderStageFlagBits::eVertex;
+        case spv::ExecutionModelTessellationControl: return vk::ShaderStageFlagBits::eTessellationControl;
+        case spv::ExecutionModelTessellationEvaluation: return vk::ShaderStageFlagBits::eTessellationEvaluation;
+        case spv::ExecutionModelGeometry: return vk::ShaderStageFlagBits::eGeometry;
+        case spv::ExecutionModelFragment: return vk::ShaderStageFlagBits::eFragment;
+        case spv::ExecutionModelGLCompute: return vk::ShaderStageFlagBits::eCompute;
+        default: throw std::runtime_error("Unsupported SPIR-V execution model.");
+        }
+    }
+
+    const Type& typeOf(uint32_t id) const {
+        auto it = _types.find(id);
+        if (it == _types.end()) throw std::runtime_error("SPIR-V references an unknown type.");
+        return it->second;
+    }
+
+    uint32_t lengthOf(uint32_t id) const {
+        const auto& type = typeOf(id);
+        if (type.specializedLength) {
+            throw std::runtime_error("Array '" + nameOf(id) + "' is sized by a specialization constant operation, which reflection cannot evaluate.");
+        }
+        return type.count;
+    }
+
+    const Decorations& decorationsOf(uint32_t id) const {
+        static const Decorations none;
+        auto it = _decorations.find(id);
+        return it == _decorations.end() ? none : it->second;
+    }
+
+    std::string nameOf(uint32_t id) const {
+        auto it = _names.find(id);
+        return it == _names.end() ? std::string() : it->second;
+    }
+
+    // byte size of a type laid out by its explicit offset and stride decorations
+    uint32_t sizeOf(uint32_t id, const MemberDecorations& member = {}) const {
+        const auto& type = typeOf(id);
+        switch (type.opcode) {
+        case spv::OpTypeBool:
+            return 4;
+        case spv::OpTypeInt:
+        case spv::OpTypeFloat:
+            return type.width / 8;
+        case spv::OpTypeVector:
+            return type.count * sizeOf(type.element);
+        case spv::OpTypeMatrix: {
+            if (member.matrixStride == 0) return type.count * sizeOf(type.element);
+            auto rows = typeOf(type.element).count;
+            return (member.rowMajor ? rows : type.count) * member.matrixStride;
+        }
+        case spv::OpTypeArray: {
+            auto stride = decorationsOf(id).arrayStride.value_or(sizeOf(type.element, member));
+            return lengthOf(id) * stride;
+        }
+        case spv::OpTypeStruct: {
+            const auto& decorations = decorationsOf(id);
+            uint32_t size = 0;
+            for (uint32_t i = 0; i < type.members.size(); ++i) {
+                auto it = decorations.members.find(i);
+                auto memberDecorations = it == decorations.members.end() ? MemberDecorations() : it->second;
+                size = std::max(size, memberDecorations.offset + sizeOf(type.members[i], memberDecorations));
+            }
+            return size;
+        }
+        case spv::OpTypePointer:
+            return 8; // physical storage buffer address
+        default:
+            return 0; // runtime arrays and opaque types have no static size
+        }
+    }
+
+    vk::Format formatOf(uint32_t id) const {
+        const auto& type = typeOf(id);
+        uint32_t components = 1;
+        const Type* scalar = &type;
+        if (type.opcode == spv::OpTypeVector) {
+            components = type.count;
+            scalar = &typeOf(type.element);
+        }
+
+        static constexpr vk::Format float16[] = { vk::Format::eR16Sfloat, vk::Format::eR16G16Sfloat, vk::Format::eR16G16B16Sfloat, vk::Format::eR16G16B16A16Sfloat };
+        static constexpr vk::Format float32[] = { vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat };
+        static constexpr vk::Format float64[] = { vk::Format::eR64Sfloat, vk::Format::eR64G64Sfloat, vk::Format::eR64G64B64Sfloat, vk::Format::eR64G64B64A64Sfloat };
+        static constexpr vk::Format sint32[] = { vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint };
+        static constexpr vk::Format uint32[] = { vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint };
+
+        if (components < 1 || components > 4) throw std::runtime_error("Unsupported vertex input vector size.");
+        if (scalar->opcode == spv::OpTypeFloat && scalar->width == 16) return float16[components - 1];
+        if (scalar->opcode == spv::OpTypeFloat && scalar->width == 32) return float32[components - 1];
+        if (scalar->opcode == spv::OpTypeFloat && scalar->width == 64) return float64[components - 1];
+        if (scalar->opcode == spv::OpTypeInt && scalar->width == 32) return scalar->isSigned ? sint32[components - 1] : uint32[components - 1];
+        throw std::runtime_error("Unsupported vertex input type.");
+    }
+
+    vk::DescriptorType descriptorTypeOf(uint32_t id, uint32_t storageClass) const {
+        const auto& type = typeOf(id);
+        if (storageClass == spv::StorageClassStorageBuffer) return vk::DescriptorType::eStorageBuffer;
+        if (storageClass == spv::StorageClassUniform) {
+            return decorationsOf(id).bufferBlock ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBuffer;
+        }
+
+        switch (type.opcode) {
+        case spv::OpTypeSampler:
+            return vk::DescriptorType::eSampler;
+        case spv::OpTypeSampledImage:
+            return vk::DescriptorType::eCombinedImageSampler;
+        case spv::OpTypeImage:
+            if (type.dim == spv::DimBuffer) {
+                return type.sampled == 2 ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+            }
+            if (type.dim == spv::DimSubpassData) return vk::DescriptorType::eInputAttachment;
+            return type.sampled == 2 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+        default:
+            throw std::runtime_error("Unsupported descriptor type in SPIR-V module.");
+        }
+    }
+
+    void reflectBinding(const Variable& variable, ShaderReflection& reflection) const {
+        const auto& decorations = decorationsOf(variable.id);
+        if (!decorations.binding.has_value()) return;
+
+        // arrays of descriptors
+        uint32_t count = 1;
+        auto id = typeOf(variable.type).element;
+        while (typeOf(id).opcode == spv::OpTypeArray) {
+            count *= lengthOf(id);
+            id = typeOf(id).element;
+        }
+        if (typeOf(id).opcode == spv::OpTypeRuntimeArray) {
+            throw std::runtime_error("Unbounded descriptor arrays are not supported.");
+        }
+
+        // a trailing runtime array has no static size, sizeOf() counts it as 0
+        bool isBlock = typeOf(id).opcode == spv::OpTypeStruct;
+        reflection.bindings.push_back({
+            .set = decorations.set.value_or(0),
+            .binding = decorations.binding.value(),
+            .type = descriptorTypeOf(id, variable.storageClass),
+            .count = count,
+            .name = nameOf(variable.id).empty() ? nameOf(id) : nameOf(variable.id),
+            .blockName = isBlock ? nameOf(id) : std::string(),
+            .size = isBlock ? sizeOf(id) : 0,
+        });
+    }
+
+    void reflectPushConstant(const Variable& variable, ShaderReflection& reflection) const {
+        auto id = typeOf(variable.type).element;
+        const auto& type = typeOf(id);
+        const auto& decorations = decorationsOf(id);
+
+        // the range starts at the first member actually declared
+        uint32_t offset = UINT32_MAX;
+        for (uint32_t i = 0; i < type.members.size(); ++i) {
+            auto it = decorations.members.find(i);
+            offset = std::min(offset, it == decorations.members.end() ? 0 : it->second.offset);
+        }
+        if (offset == UINT32_MAX) return;
+
+        vk::PushConstantRange range;
+        range
+        .setStageFlags(reflection.stage)
+        .setOffset(offset)
+        .setSize(sizeOf(id) - offset);
+        reflection.pushConstantRange = range;
+    }
+
+    void reflectInput(const Variable& variable, ShaderReflection& reflection) const {
+        const auto& decorations = decorationsOf(variable.id);
+        auto id = typeOf(variable.type).element;
+        if (decorations.builtIn || typeOf(id).opcode == spv::OpTypeStruct) return; // gl_VertexIndex, gl_PerVertex...
+        if (!decorations.location.has_value()) throw std::runtime_error("Vertex input without location.");
+
+        // arrays and matrices take one location per element or column
+        auto location = decorations.location.value();
+        uint32_t count = 1;
+        while (typeOf(id).opcode == spv::OpTypeArray) {
+            count *= lengthOf(id);
+            id = typeOf(id).element;
+        }
+        if (typeOf(id).opcode == spv::OpTypeMatrix) {
+            count *= typeOf(id).count;
+            id = typeOf(id).element;
+        }
+
+        for (uint32_t i = 0; i < count; ++i) {
+            reflection.inputs.push_back({
+                .location = location + i,
+                .format = formatOf(id),
+                .size = sizeOf(id),
+                .name = nameOf(variable.id),
+            });
+        }
+    }
+};
+
+}
+
+ShaderReflection ReflectSpirv(std::span<const uint32_t> code) {
+    return Module(code).Reflect();
+}
+
+}
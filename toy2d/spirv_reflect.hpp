@@ -0,0 +1,50 @@
+/**
+  * @file   spirv_reflect.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace toy2d {
+
+// the part of a SPIR-V module's interface toy2d builds pipelines from
+struct ShaderReflection {
+    struct Binding {
+        uint32_t set;
+        uint32_t binding;
+        vk::DescriptorType type;
+        uint32_t count; // > 1 for arrays of descriptors
+        std::string name;
+        std::string blockName; // the block's type name, for uniform and storage blocks
+        uint32_t size = 0;     // of the block, 0 if it ends in a runtime array or is not a block
+    };
+
+    struct Input {
+        uint32_t location;
+        vk::Format format; // the 32-bit (or declared width) format matching the GLSL type
+        uint32_t size;
+        std::string name;
+    };
+
+    vk::ShaderStageFlagBits stage;
+    std::string entryPoint;
+    std::vector<Binding> bindings;
+    std::optional<vk::PushConstantRange> pushConstantRange;
+    std::vector<Input> inputs; // sorted by location, only filled for vertex shaders
+};
+
+// parses decorations, types and the entry point interface of a SPIR-V binary.
+// only variables the entry point lists in its interface or statically references are reflected
+ShaderReflection ReflectSpirv(std::span<const uint32_t> code);
+
+}
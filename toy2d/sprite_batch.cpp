@@ -0,0 +1,101 @@
+/**
+  * @file   sprite_batch.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "sprite_batch.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace toy2d {
+
+QuantizationFrame QuantizationFrame::Fit(vec2 min, vec2 max) {
+    QuantizationFrame frame;
+    frame.origin = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f };
+    // a degenerate axis still needs a non-zero scale to decode with
+    frame.halfExtent = { std::max((max.x - min.x) * 0.5f, 1e-6f), std::max((max.y - min.y) * 0.5f, 1e-6f) };
+    return frame;
+}
+
+snorm16x2 QuantizationFrame::Encode(vec2 position) const {
+    return snorm16x2::FromFloat((position.x - origin.x) / halfExtent.x, (position.y - origin.y) / halfExtent.y);
+}
+
+PushConstantObject QuantizationFrame::Apply(const PushConstantObject& pushConstant) const {
+    // fold the decode into the affine transform the shaders already apply
+    const auto& m = pushConstant.transform; // column-major
+    PushConstantObject result = pushConstant;
+    result.transform = { m[0] * halfExtent.x, m[1] * halfExtent.x, m[2] * halfExtent.y, m[3] * halfExtent.y };
+    result.offset = {
+        m[0] * origin.x + m[2] * origin.y + pushConstant.offset[0],
+        m[1] * origin.x + m[3] * origin.y + pushConstant.offset[1],
+    };
+    return result;
+}
+
+void SpriteBatch::Add(const Sprite& sprite) {
+    if (_sprites.size() >= maxSprites) {
+        throw std::runtime_error("Sprite batch is full, split it into several batches.");
+    }
+    _sprites.push_back(sprite);
+}
+
+void SpriteBatch::Clear() {
+    _sprites.clear();
+}
+
+size_t SpriteBatch::size() const {
+    return _sprites.size();
+}
+
+QuantizationFrame SpriteBatch::Build(std::vector<SpriteVertex>& vertices, std::vector<uint16_t>& indices) const {
+    vertices.clear();
+    indices.clear();
+    if (_sprites.empty()) return {};
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    vec2 min { inf, inf }, max { -inf, -inf };
+    for (const auto& sprite : _sprites) {
+        min = { std::min(min.x, sprite.center.x - sprite.size.x * 0.5f), std::min(min.y, sprite.center.y - sprite.size.y * 0.5f) };
+        max = { std::max(max.x, sprite.center.x + sprite.size.x * 0.5f), std::max(max.y, sprite.center.y + sprite.size.y * 0.5f) };
+    }
+    auto frame = QuantizationFrame::Fit(min, max);
+
+    vertices.reserve(_sprites.size() * 4);
+    indices.reserve(_sprites.size() * 6);
+    for (const auto& sprite : _sprites) {
+        auto first = static_cast<uint16_t>(vertices.size());
+        float left = sprite.center.x - sprite.size.x * 0.5f, right = sprite.center.x + sprite.size.x * 0.5f;
+        float top = sprite.center.y - sprite.size.y * 0.5f, bottom = sprite.center.y + sprite.size.y * 0.5f;
+        auto color = unorm8x4::FromFloat(sprite.color.x, sprite.color.y, sprite.color.z, sprite.color.w);
+
+        // same winding as the rectangle: top left, top right, bottom right, bottom left
+        vertices.push_back({ frame.Encode({ left, top }), unorm16x2::FromFloat(sprite.uvMin.x, sprite.uvMin.y), color });
+        vertices.push_back({ frame.Encode({ right, top }), unorm16x2::FromFloat(sprite.uvMax.x, sprite.uvMin.y), color });
+        vertices.push_back({ frame.Encode({ right, bottom }), unorm16x2::FromFloat(sprite.uvMax.x, sprite.uvMax.y), color });
+        vertices.push_back({ frame.Encode({ left, bottom }), unorm16x2::FromFloat(sprite.uvMin.x, sprite.uvMax.y), color });
+        for (uint16_t corner : { 0, 1, 2, 2, 3, 0 }) indices.push_back(first + corner);
+    }
+    return frame;
+}
+
+void SpriteBatch::BuildRecords(std::vector<SpriteRecord>& records) const {
+    records.clear();
+    records.reserve(_sprites.size());
+    for (const auto& sprite : _sprites) {
+        records.push_back({
+            .center = sprite.center,
+            .halfSize = { sprite.size.x * 0.5f, sprite.size.y * 0.5f },
+            .uvRect = { sprite.uvMin.x, sprite.uvMin.y, sprite.uvMax.x, sprite.uvMax.y },
+            .color = unorm8x4::FromFloat(sprite.color.x, sprite.color.y, sprite.color.z, sprite.color.w),
+            .kind = sprite.kind,
+            .reserved = { 0, 0 },
+        });
+    }
+}
+
+}
@@ -0,0 +1,83 @@
+/**
+  * @file   sprite_batch.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vertex.hpp"
+#include "uniform.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace toy2d {
+
+// positions are stored as snorm16 relative to the bounds of their batch,
+// the vertex fetch decodes them to [-1, 1] and the push constant transform scales them back
+struct QuantizationFrame {
+    vec2 origin { 0.0f, 0.0f };     // center of the bounds
+    vec2 halfExtent { 1.0f, 1.0f };
+
+    static QuantizationFrame Fit(vec2 min, vec2 max);
+
+    snorm16x2 Encode(vec2 position) const;
+    PushConstantObject Apply(const PushConstantObject& pushConstant) const; // transform * (halfExtent * p + origin) + offset
+};
+
+enum class SpriteKind : uint32_t {
+    Textured, // color * texture
+    Solid,    // color only, the texture is not read
+};
+
+struct Sprite {
+    vec2 center;
+    vec2 size;
+    vec2 uvMin { 0.0f, 0.0f };
+    vec2 uvMax { 1.0f, 1.0f };
+    vec4 color { 1.0f, 1.0f, 1.0f, 1.0f };
+    SpriteKind kind = SpriteKind::Textured; // only the vertex pulling path tells kinds apart
+};
+
+// one sprite as fetched by sprite-pull.vert through gl_InstanceIndex, std430 layout
+struct SpriteRecord {
+    vec2 center;
+    vec2 halfSize;
+    vec4 uvRect; // min in xy, max in zw
+    unorm8x4 color;
+    SpriteKind kind;
+    uint32_t reserved[2];
+};
+
+static_assert(sizeof(SpriteRecord) == 48 && alignof(SpriteRecord) == 4);
+
+// one entry of the layer table sprite-scene.vert walks through PushConstantObject::scene
+struct SpriteLayer {
+    vk::DeviceAddress records; // first SpriteRecord of the layer
+    uint32_t count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SpriteLayer) == 16);
+
+class SpriteBatch {
+public:
+    static constexpr size_t maxSprites = 65536 / 4; // four corners each, addressed with 16-bit indices
+
+private:
+    std::vector<Sprite> _sprites;
+
+public:
+    void Add(const Sprite& sprite);
+    void Clear();
+    size_t size() const;
+
+    // quantizes every corner against the bounds of the whole batch, six indices per sprite
+    QuantizationFrame Build(std::vector<SpriteVertex>& vertices, std::vector<uint16_t>& indices) const;
+    // one record per sprite, drawn as instances of six vertices without vertex input
+    void BuildRecords(std::vector<SpriteRecord>& records) const;
+};
+
+}
@@ -0,0 +1,78 @@
+/**
+  * @file   staging_ring.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "staging_ring.hpp"
+
+#include "context.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace toy2d {
+
+StagingRing::StagingRing(vk::DeviceSize capacity) : _capacity(capacity) {
+    _buffer.reset(new Buffer(capacity, vk::BufferUsageFlagBits::eTransferSrc, std::vector { MemoryRequest::Upload() }));
+    // stays mapped until the buffer is freed
+    _mapped = static_cast<std::byte*>(Context::GetInstance().device.mapMemory(_buffer->memory, 0, VK_WHOLE_SIZE));
+}
+
+StagingRing::Allocation StagingRing::Allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    auto position = (_head + alignment - 1) / alignment * alignment;
+    auto offset = position % _capacity;
+    if (offset + size > _capacity) {
+        // never wraps inside an allocation, the end of the buffer is skipped
+        position += _capacity - offset;
+        offset = 0;
+    }
+    if (size > _capacity || position + size - _tail > _capacity) return allocateOverflow(size);
+
+    _head = position + size;
+    return { _buffer->buffer, offset, _mapped + offset };
+}
+
+StagingRing::Allocation StagingRing::allocateOverflow(vk::DeviceSize size) {
+    // large textures or a burst of uploads, rare enough for a dedicated allocation
+    auto& overflow = _overflow.emplace_back(_frameNumber, std::make_unique<Buffer>(
+        size,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        std::vector { MemoryRequest::Upload() }
+    ));
+    _overflowBytes += size;
+    auto mapped = static_cast<std::byte*>(Context::GetInstance().device.mapMemory(overflow.buffer->memory, 0, VK_WHOLE_SIZE));
+    return { overflow.buffer->buffer, 0, mapped };
+}
+
+void StagingRing::BeginFrame(size_t slot) {
+    if (slot >= _slots.size() || !_slots[slot]) return;
+
+    auto retired = *std::exchange(_slots[slot], std::nullopt);
+    _tail = std::max(_tail, retired.head);
+    while (!_overflow.empty() && _overflow.front().frame <= retired.number) {
+        _overflowBytes -= _overflow.front().buffer->size;
+        _overflow.pop_front();
+    }
+}
+
+void StagingRing::EndFrame(size_t slot) {
+    if (slot >= _slots.size()) _slots.resize(slot + 1);
+    _slots[slot] = Frame { _frameNumber, _head };
+    ++_frameNumber;
+}
+
+vk::DeviceSize StagingRing::getCapacity() const {
+    return _capacity;
+}
+
+vk::DeviceSize StagingRing::getUsedBytes() const {
+    return _head - _tail;
+}
+
+vk::DeviceSize StagingRing::getOverflowBytes() const {
+    return _overflowBytes;
+}
+
+}
@@ -0,0 +1,75 @@
+/**
+  * @file   staging_ring.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "buffer.hpp"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace toy2d {
+
+// one persistently mapped upload buffer every staging copy sub-allocates from.
+// space is handed back once the frame that consumed it retired, i.e. its slot's fence was waited.
+// requests the ring has no room for get a dedicated buffer, released the same way.
+// not thread-safe: allocations are tied to the render thread's frames and consumed by submits on its queue
+class StagingRing {
+public:
+    struct Allocation {
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+        std::byte* data; // mapped, coherent
+    };
+
+private:
+    struct Frame {
+        uint64_t number;
+        uint64_t head; // ring position after everything the frame consumed
+    };
+
+    struct Overflow {
+        uint64_t frame; // retired with this frame
+        std::unique_ptr<Buffer> buffer;
+    };
+
+    std::unique_ptr<Buffer> _buffer;
+    std::byte* _mapped;
+    vk::DeviceSize _capacity;
+
+    // positions grow forever, the offset in the buffer is position % capacity
+    uint64_t _head = 0;
+    uint64_t _tail = 0;
+    uint64_t _frameNumber = 0; // of the frame being built, allocations belong to it
+    std::vector<std::optional<Frame>> _slots;
+    std::deque<Overflow> _overflow;
+    vk::DeviceSize _overflowBytes = 0;
+
+public:
+    explicit StagingRing(vk::DeviceSize capacity);
+    StagingRing(const StagingRing&) = delete;
+
+    Allocation Allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16); // valid until the frame being built retires
+
+    void BeginFrame(size_t slot); // after waiting the slot's fence
+    void EndFrame(size_t slot);   // after the submit that consumes everything allocated so far
+
+    vk::DeviceSize getCapacity() const;
+    vk::DeviceSize getUsedBytes() const;     // ring space not yet retired
+    vk::DeviceSize getOverflowBytes() const; // in dedicated buffers not yet retired
+
+private:
+    Allocation allocateOverflow(vk::DeviceSize size);
+};
+
+}
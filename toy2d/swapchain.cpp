@@ -121,6 +121,9 @@ void Swapchain::createImageViews() {
 }
 
 void Swapchain::createFramebuffers(int w, int h) {
+    // dynamic rendering draws into the image views directly
+    if (Context::GetInstance().renderProcess->dynamicRendering) return;
+
     framebuffers.resize(images.size());
     for (size_t i = 0; i < framebuffers.size(); ++i) {
         vk::FramebufferCreateInfo createInfo;
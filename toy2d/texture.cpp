@@ -10,51 +10,98 @@
 #include "stb/stb_image.h"
 
 #include "context.hpp"
+#include "texture_cache.hpp"
 
+#include <array>
+#include <cstring>
 #include <memory>
+#include <optional>
+#include <span>
 #include <format>
+#include <utility>
 
 namespace toy2d {
 
-Texture::Texture(std::string_view imagePath) {
+namespace {
+
+constexpr vk::Format textureFormat = vk::Format::eR8G8B8A8Srgb;
+
+struct Pixels {
+    std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> decoded { nullptr, &stbi_image_free };
+    std::optional<TextureCache::Entry> cached;
+    const void* data = nullptr;
+    uint32_t w = 0;
+    uint32_t h = 0;
+};
+
+Pixels LoadPixels(std::string_view imagePath) {
+    auto& ctx = Context::GetInstance();
+    auto file = ctx.assets->Load(imagePath);
+    Pixels pixels;
+
+    if (ctx.textureCache) {
+        auto cached = ctx.textureCache->Find(file.data());
+        if (cached && cached->format == textureFormat &&
+            cached->texels.size() == static_cast<size_t>(cached->width) * cached->height * 4) {
+            pixels.w = cached->width;
+            pixels.h = cached->height;
+            pixels.data = cached->texels.data();
+            pixels.cached = std::move(cached); // moving the mapping keeps the texel address
+            return pixels;
+        }
+    }
+
+    // decoded straight from the mapped pages, stb never copies the encoded file
     int w, h, channel;
-    stbi_uc* pixels = stbi_load(imagePath.data(), &w, &h, &channel, STBI_rgb_alpha);
-    size_t size = w * h * 4;
+    pixels.decoded.reset(stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data().data()), static_cast<int>(file.size()),
+                                               &w, &h, &channel, STBI_rgb_alpha));
 
-    if (!pixels) {
+    if (!pixels.decoded) {
         std::cerr << "Failed to load texture image: " << imagePath << std::endl;
         throw std::runtime_error("Failed to load texture image.");
     }
+    pixels.w = static_cast<uint32_t>(w);
+    pixels.h = static_cast<uint32_t>(h);
+    pixels.data = pixels.decoded.get();
 
-    std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>(
-        size,
-        vk::BufferUsageFlagBits::eTransferSrc,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-    );
+    if (ctx.textureCache) {
+        std::span<const std::byte> texels(reinterpret_cast<const std::byte*>(pixels.data), static_cast<size_t>(w) * h * 4);
+        ctx.textureCache->Store(file.data(), pixels.w, pixels.h, textureFormat, texels);
+    }
+    return pixels;
+}
 
-    auto& device = Context::GetInstance().device;
-    void* mapped = device.mapMemory(buffer->memory, 0, size); {
-        std::memcpy(mapped, pixels, size);
-    } device.unmapMemory(buffer->memory);
+}
 
-    createImage(w, h);
+Texture::Texture(std::string_view imagePath) {
+    auto pixels = LoadPixels(imagePath);
+    width = pixels.w;
+    height = pixels.h;
+
+    auto& device = Context::GetInstance().device;
+    createImage(width, height);
     allocMemory();
     device.bindImageMemory(image, memory, 0);
+    createImageView();
 
-    transitionImageLayoutFromUndefinedToDst();
-    transformDataToImage(*buffer, w, h);
-    transitionImageLayoutFromDstToShaderReadOnly();
+    TextureUploader uploader;
+    uploader.Enqueue(*this, pixels.data);
+    uploader.Submit();
+}
 
+Texture::Texture(uint32_t w, uint32_t h): width(w), height(h) {
+    auto& device = Context::GetInstance().device;
+    createImage(width, height);
+    allocMemory();
+    device.bindImageMemory(image, memory, 0);
     createImageView();
-
-    stbi_image_free(pixels);
 }
 
 Texture::~Texture() {
-    auto& device = Context::GetInstance().device;
-    device.destroyImageView(view);
-    device.freeMemory(memory);
-    device.destroyImage(image);
+    auto& ctx = Context::GetInstance();
+    ctx.device.destroyImageView(view);
+    ctx.memoryManager->Free(memory);
+    ctx.device.destroyImage(image);
 }
 
 void Texture::createImage(uint32_t w, uint32_t h) {
@@ -64,7 +111,7 @@ void Texture::createImage(uint32_t w, uint32_t h) {
     .setArrayLayers(1)
     .setMipLevels(1)
     .setExtent({w, h, 1})
-    .setFormat(vk::Format::eR8G8B8A8Srgb)
+    .setFormat(textureFormat)
     .setTiling(vk::ImageTiling::eOptimal)
     .setInitialLayout(vk::ImageLayout::eUndefined)
     .setUsage(vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst)
@@ -86,7 +133,7 @@ void Texture::createImageView() {
 
     createInfo
     .setImage(image)
-    .setFormat(vk::Format::eR8G8B8A8Srgb)
+    .setFormat(textureFormat)
     .setViewType(vk::ImageViewType::e2D)
     .setComponents(mapping)
     .setSubresourceRange(range);
@@ -94,93 +141,84 @@ void Texture::createImageView() {
     view = Context::GetInstance().device.createImageView(createInfo);
 }
 
-void Texture::allocMemory() {;
-    auto& device = Context::GetInstance().device;
-    vk::MemoryAllocateInfo allocInfo;
-
-    auto requirements = device.getImageMemoryRequirements(image);
-    allocInfo.setAllocationSize(requirements.size);
-
-    auto index = Buffer::QueryMemoryTypeIndex(requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-    if (!index.has_value()) {
-        throw std::runtime_error("Failed to find suitable memory type for texture image.");
-    }
-    allocInfo.setMemoryTypeIndex(index.value());
+void Texture::allocMemory() {
+    auto& ctx = Context::GetInstance();
+    auto requirements = ctx.device.getImageMemoryRequirements(image);
+    memory = ctx.memoryManager->Allocate(requirements, std::array { MemoryRequest::DeviceOnly() }, MemoryCategory::Texture,
+                                         static_cast<vk::DeviceSize>(width) * height * 4);
+}
 
-    memory = device.allocateMemory(allocInfo);
+void TextureUploader::Enqueue(Texture& texture, const void* pixels) {
+    _uploads.push_back({ &texture, pixels, nullptr });
 }
 
-void Texture::transitionImageLayoutFromUndefinedToDst() {
-    auto& ctx = Context::GetInstance();
-    ctx.commandManager->ExecuteCommand(ctx.graphicsQueue, [&](const vk::CommandBuffer& cmdBuf) {
-       vk::ImageMemoryBarrier barrier;
-       vk::ImageSubresourceRange range;
-       range
-       .setLayerCount(1)
-       .setBaseArrayLayer(0)
-       .setLevelCount(1)
-       .setBaseMipLevel(0)
-       .setAspectMask(vk::ImageAspectFlagBits::eColor);
-       barrier
-       .setImage(image)
-       .setOldLayout(vk::ImageLayout::eUndefined)
-       .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
-       .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-       .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-       .setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
-       .setSubresourceRange(range);
-       cmdBuf.pipelineBarrier(
-           vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,{},
-           {}, {}, barrier
-       );
-    });
+Texture& TextureUploader::Load(std::string_view imagePath) {
+    auto pixels = std::make_shared<Pixels>(LoadPixels(imagePath));
+    auto& texture = *_loaded.emplace_back(std::make_unique<Texture>(pixels->w, pixels->h));
+    _uploads.push_back({ &texture, pixels->data, pixels }); // stb's output or the cache mapping, held until Submit()
+    return texture;
 }
 
-void Texture::transitionImageLayoutFromDstToShaderReadOnly() {
+void TextureUploader::Submit() {
+    if (_uploads.empty()) return;
+
     auto& ctx = Context::GetInstance();
-    ctx.commandManager->ExecuteCommand(ctx.graphicsQueue, [&](const vk::CommandBuffer& cmdBuf) {
-        vk::ImageMemoryBarrier barrier;
-        vk::ImageSubresourceRange range;
-        range
-        .setLayerCount(1)
+
+    // one copy from stb's output or the mapped cache file into the ring, 4 byte alignment is all bufferOffset needs for rgba8.
+    // taken here and not on Enqueue(), the ring reclaims space per rendered frame and ExecuteCommand waits for the copies
+    std::vector<StagingRing::Allocation> staging;
+    staging.reserve(_uploads.size());
+    for (const auto& upload : _uploads) {
+        auto size = static_cast<size_t>(upload.texture->width) * upload.texture->height * 4;
+        staging.push_back(ctx.stagingRing->Allocate(size, 4));
+        std::memcpy(staging.back().data, upload.pixels, size);
+    }
+
+    // a single pass writing every image, so the graph emits one batch of image barriers on each side of the copies
+    RenderGraph graph;
+    std::vector<RenderGraph::ResourceHandle> targets;
+    targets.reserve(_uploads.size());
+    for (const auto& upload : _uploads) {
+        targets.push_back(graph.ImportImage("texture", upload.texture->image, upload.texture->view,
+                                            RenderGraph::Access::None, RenderGraph::Access::FragmentShaderRead));
+    }
+    graph.AddPass("upload", [&](RenderGraph::PassBuilder& builder) {
+        for (auto target : targets) builder.Write(target, RenderGraph::Access::TransferWrite);
+    }, [&](vk::CommandBuffer& cmdBuf) {
+        vk::ImageSubresourceLayers subresource;
+        subresource
+        .setAspectMask(vk::ImageAspectFlagBits::eColor)
         .setBaseArrayLayer(0)
-        .setLevelCount(1)
-        .setBaseMipLevel(0)
-        .setAspectMask(vk::ImageAspectFlagBits::eColor);
-        barrier
-        .setImage(image)
-        .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-        .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-        .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-        .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-        .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
-        .setDstAccessMask(vk::AccessFlagBits::eShaderRead)
-        .setSubresourceRange(range);
-        cmdBuf.pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{},
-            {}, {}, barrier
-        );
+        .setLayerCount(1)
+        .setMipLevel(0);
+        for (size_t i = 0; i < _uploads.size(); ++i) {
+            auto texture = _uploads[i].texture;
+            vk::BufferImageCopy region;
+            region
+            .setImageSubresource(subresource)
+            .setImageExtent({texture->width, texture->height, 1})
+            .setBufferImageHeight(0)
+            .setBufferRowLength(0)
+            .setBufferOffset(staging[i].offset);
+            cmdBuf.copyBufferToImage(staging[i].buffer, texture->image, vk::ImageLayout::eTransferDstOptimal, region);
+        }
     });
-}
+    graph.Compile();
 
-void Texture::transformDataToImage(const toy2d::Buffer& buffer, uint32_t w, uint32_t h) {
-    auto& ctx = Context::GetInstance();
     ctx.commandManager->ExecuteCommand(ctx.graphicsQueue, [&](const vk::CommandBuffer& cmdBuf) {
-       vk::BufferImageCopy region;
-       vk::ImageSubresourceLayers subresource;
-       subresource
-       .setAspectMask(vk::ImageAspectFlagBits::eColor)
-       .setBaseArrayLayer(0)
-       .setLayerCount(1)
-       .setMipLevel(0);
-       region
-       .setImageSubresource(subresource)
-       .setImageExtent({w, h, 1})
-       .setBufferImageHeight(0)
-       .setBufferRowLength(0)
-       .setBufferOffset(0);
-       cmdBuf.copyBufferToImage(buffer.buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
+        auto recording = cmdBuf;
+        graph.Execute(recording);
     });
+
+    _uploads.clear();
+}
+
+std::vector<std::unique_ptr<Texture>> TextureUploader::TakeLoaded() {
+    return std::exchange(_loaded, {});
+}
+
+bool TextureUploader::empty() const {
+    return _uploads.empty();
 }
 
 }
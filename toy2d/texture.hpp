@@ -10,6 +10,13 @@
 #include "vulkan/vulkan.hpp"
 
 #include "buffer.hpp"
+#include "render_graph.hpp"
+
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace toy2d {
 
@@ -19,17 +26,41 @@ public:
     vk::ImageView view;
     vk::DeviceMemory memory;
 
+    uint32_t width;
+    uint32_t height;
+
 public:
     Texture(std::string_view imagePath);
+    Texture(uint32_t w, uint32_t h); // contents are undefined until uploaded
     ~Texture();
 
 private:
     void createImage(uint32_t w, uint32_t h);
     void createImageView();
     void allocMemory();
-    void transitionImageLayoutFromUndefinedToDst();
-    void transitionImageLayoutFromDstToShaderReadOnly();
-    void transformDataToImage(const Buffer& buffer, uint32_t w, uint32_t h);
+};
+
+// collects the pixels of many textures and uploads them with one submit:
+// one barrier batch to transfer dst, the copies, one batch to shader read.
+// staging space is only taken from the ring inside Submit(), which waits for the copies, so frames may be rendered in between
+class TextureUploader {
+private:
+    struct Upload {
+        Texture* texture;
+        const void* pixels;                 // rgba8, copied into the staging ring by Submit()
+        std::shared_ptr<const void> source; // keeps the pixels of Load() alive, empty for Enqueue()
+    };
+
+    std::vector<Upload> _uploads;
+    std::vector<std::unique_ptr<Texture>> _loaded;
+
+public:
+    void Enqueue(Texture& texture, const void* pixels); // rgba8, texture.width * texture.height texels, read by Submit()
+    Texture& Load(std::string_view imagePath);          // owned by the uploader until TakeLoaded()
+
+    void Submit();
+    std::vector<std::unique_ptr<Texture>> TakeLoaded();
+    bool empty() const;
 };
 
 }
@@ -0,0 +1,149 @@
+/**
+  * @file   texture_cache.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "texture_cache.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <utility>
+
+namespace toy2d {
+
+namespace {
+
+constexpr char cacheMagic[4] = { 'T', '2', 'D', 'T' };
+constexpr uint32_t cacheVersion = 2; // bump when the decode or the layout of the texels changes
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash[2];
+    uint64_t sourceSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format; // vk::Format
+    uint32_t reserved;
+    uint64_t texelOffset;
+    uint64_t texelSize;
+};
+
+constexpr uint64_t texelAlignment = 64; // keeps the texels cache line aligned inside the mapping
+static_assert(sizeof(CacheHeader) <= texelAlignment);
+
+uint64_t ReadWord(const std::byte* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+}
+
+TextureCache::TextureCache(std::filesystem::path directory) : _directory(std::move(directory)) {}
+
+TextureCache::ContentHash TextureCache::HashContent(std::span<const std::byte> bytes) {
+    // word at a time, hashing must stay well below the cost of the decode it replaces
+    uint64_t low = 0x9e3779b97f4a7c15ull ^ bytes.size();
+    uint64_t high = 0xc2b2ae3d27d4eb4full + bytes.size();
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+        auto word = ReadWord(bytes.data() + i);
+        low = Mix(low ^ word) * 0x9e3779b97f4a7c15ull;
+        high = Mix(high + std::rotl(word, 29)) * 0xbf58476d1ce4e5b9ull;
+    }
+    uint64_t tail = 0;
+    if (i < bytes.size()) std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+    return { Mix(low ^ tail), Mix(high + std::rotl(tail, 29)) };
+}
+
+std::filesystem::path TextureCache::entryPath(std::span<const std::byte> encoded, const ContentHash& hash) const {
+    return _directory / std::format("{:016x}{:016x}-{}.tex", hash.high, hash.low, encoded.size());
+}
+
+std::optional<TextureCache::Entry> TextureCache::Find(std::span<const std::byte> encoded) const {
+    auto hash = HashContent(encoded);
+    auto path = entryPath(encoded, hash);
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) return std::nullopt;
+
+    try {
+        MappedFile file(path.string(), MappedFile::Hint::Sequential);
+        auto bytes = file.data();
+        if (bytes.size() < sizeof(CacheHeader)) return std::nullopt;
+
+        CacheHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+            header.sourceHash[0] != hash.low || header.sourceHash[1] != hash.high || header.sourceSize != encoded.size() ||
+            header.texelOffset > bytes.size() || header.texelSize > bytes.size() - header.texelOffset) {
+            return std::nullopt; // stale or truncated, overwritten by the next Store
+        }
+
+        auto texels = bytes.subspan(header.texelOffset, header.texelSize);
+        return Entry { std::move(file), header.width, header.height, static_cast<vk::Format>(header.format), texels };
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+}
+
+void TextureCache::Store(std::span<const std::byte> encoded, uint32_t width, uint32_t height, vk::Format format,
+                         std::span<const std::byte> texels) const {
+    auto hash = HashContent(encoded);
+    auto path = entryPath(encoded, hash);
+
+    CacheHeader header {};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.sourceHash[0] = hash.low;
+    header.sourceHash[1] = hash.high;
+    header.sourceSize = encoded.size();
+    header.width = width;
+    header.height = height;
+    header.format = static_cast<uint32_t>(format);
+    header.texelOffset = texelAlignment;
+    header.texelSize = texels.size();
+
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+
+    // written aside under a name unique to this writer and renamed, so concurrent or interrupted runs never map half a file
+    static std::atomic<uint32_t> writes = 0;
+    auto temporary = path;
+    temporary += std::format(".{:08x}{:08x}.tmp", std::random_device{}(), writes.fetch_add(1));
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        std::string padding(texelAlignment - sizeof(header), '\0');
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(texels.data()), static_cast<std::streamsize>(texels.size()));
+        if (!out) {
+            std::cerr << "Failed to write texture cache: " << temporary.string() << std::endl;
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::cerr << "Failed to write texture cache: " << path.string() << std::endl;
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+}
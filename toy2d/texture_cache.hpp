@@ -0,0 +1,58 @@
+/**
+  * @file   texture_cache.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "mapped_file.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+namespace toy2d {
+
+// decoded texels on disk, keyed by a hash of the encoded image,
+// so warm starts map them straight into the staging buffer instead of inflating the png again
+class TextureCache {
+public:
+    struct Entry {
+        MappedFile file;
+        uint32_t width;
+        uint32_t height;
+        vk::Format format;
+        std::span<const std::byte> texels; // the exact bytes TextureUploader copies, tightly packed rows
+    };
+
+    // two independently seeded lanes, a collision would silently hand out the texels of another image
+    struct ContentHash {
+        uint64_t low;
+        uint64_t high;
+
+        bool operator==(const ContentHash& other) const = default;
+    };
+
+private:
+    std::filesystem::path _directory;
+
+public:
+    explicit TextureCache(std::filesystem::path directory);
+
+    std::optional<Entry> Find(std::span<const std::byte> encoded) const;
+    void Store(std::span<const std::byte> encoded, uint32_t width, uint32_t height, vk::Format format,
+               std::span<const std::byte> texels) const; // best effort, a failed write only costs the next start a decode
+
+    static ContentHash HashContent(std::span<const std::byte> bytes);
+
+private:
+    std::filesystem::path entryPath(std::span<const std::byte> encoded, const ContentHash& hash) const;
+};
+
+}
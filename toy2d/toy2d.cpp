@@ -9,29 +9,64 @@
 
 #include "utility.hpp"
 #include "context.hpp"
-#include "shader.hpp"
 
 namespace toy2d {
 
 void Init(const std::vector<const char*>& extensions, CreateSurfaceFunc createSurface, int w, int h) {
     Context::Init(extensions, createSurface);
     auto& ctx = Context::GetInstance();
+    ctx.InitMemoryManager();
+    ctx.InitStagingRing(16 << 20); // 16 MiB, a few frames of uploads, bigger bursts get dedicated buffers
+    ctx.InitAssets({ "assets.pack" });
+    ctx.InitTextureCache(".cache/textures");
+    ctx.InitLayoutCache();
     ctx.InitSwapchain(w, h);
-    Shader::Init(ReadShaderFile("shader/texture-rect.vert.spv"),ReadShaderFile("shader/texture.frag.spv"));
-    ctx.InitRenderProcess(w, h);
+    ctx.InitRenderProcess();
     ctx.CreateFramebuffers(w, h);
+    ctx.InitPipelineRegistry();
+    auto loadProgram = [&](std::string name, const std::string& vertexPath, const std::string& fragmentPath) {
+        auto vertexCode = ctx.assets->Load(vertexPath, MappedFile::Hint::WillNeed);
+        auto fragmentCode = ctx.assets->Load(fragmentPath, MappedFile::Hint::WillNeed);
+        return ctx.pipelineRegistry->RegisterProgram(std::move(name), vertexCode.data(), fragmentCode.data());
+    };
+    auto texture = loadProgram("texture", "shader/texture-rect.vert.spv", "shader/texture.frag.spv");
+    auto colorful = loadProgram("colorful", "shader/rect.vert.spv", "shader/colorful-uniform.frag.spv");
+    auto sprite = loadProgram("sprite", "shader/sprite.vert.spv", "shader/sprite.frag.spv");
+    auto spritePull = loadProgram("sprite-pull", "shader/sprite-pull.vert.spv", "shader/sprite-pull.frag.spv");
+    std::optional<ProgramHandle> spriteScene;
+    if (ctx.features.bufferDeviceAddress) {
+        // same fragment stage as sprite-pull, only the record fetch differs
+        spriteScene = loadProgram("sprite-scene", "shader/sprite-scene.vert.spv", "shader/sprite-pull.frag.spv");
+    }
     ctx.InitCommandManager();
     ctx.InitRenderer();
+#ifndef NDEBUG
+    // edit the GLSL sources while running, affected pipelines are rebuilt in the background
+    std::vector<ShaderReloader::WatchedProgram> watched = {
+        { texture, "shader/texture-rect.vert", "shader/texture.frag" },
+        { colorful, "shader/rect.vert", "shader/colorful-uniform.frag" },
+        { sprite, "shader/sprite.vert", "shader/sprite.frag" },
+        { spritePull, "shader/sprite-pull.vert", "shader/sprite-pull.frag" },
+    };
+    if (spriteScene) watched.push_back({ *spriteScene, "shader/sprite-scene.vert", "shader/sprite-pull.frag" });
+    ctx.InitShaderReloader(watched);
+#endif
 }
 
 void Quit() {
     auto& ctx = Context::GetInstance();
+    ctx.DestroyShaderReloader();
     ctx.device.waitIdle();
     ctx.DestroyRenderer();
+    ctx.DestroyStagingRing();
     ctx.DestroyCommandManager();
+    ctx.DestroyPipelineRegistry();
     ctx.DestroyRenderProcess();
-    Shader::Quit();
+    ctx.DestroyLayoutCache();
     ctx.DestroySwapchain();
+    ctx.DestroyTextureCache();
+    ctx.DestroyAssets();
+    ctx.DestroyMemoryManager();
     Context::Quit();
 }
 
@@ -39,4 +74,12 @@ Renderer& GetRenderer() {
     return *Context::GetInstance().renderer;
 }
 
+PipelineRegistry& GetPipelineRegistry() {
+    return *Context::GetInstance().pipelineRegistry;
+}
+
+MemoryManager& GetMemoryManager() {
+    return *Context::GetInstance().memoryManager;
+}
+
 }
@@ -12,6 +12,8 @@
 #include "vulkan/vulkan.hpp"
 
 #include "renderer.hpp"
+#include "pipeline_registry.hpp"
+#include "memory_manager.hpp"
 
 #include <vector>
 #include <functional>
@@ -22,5 +24,7 @@ void Init(const std::vector<const char*>& extensions, CreateSurfaceFunc createSu
 void Quit();
 
 Renderer& GetRenderer();
+PipelineRegistry& GetPipelineRegistry();
+MemoryManager& GetMemoryManager();
 
 }
@@ -13,10 +13,19 @@ vk::DescriptorSetLayoutBinding UniformObject::getBinding() {
     vk::DescriptorSetLayoutBinding binding;
     binding
     .setBinding(0)
-    .setDescriptorType(vk::DescriptorType::eUniformBuffer)
+    .setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
     .setDescriptorCount(1) // 1+ if array
     .setStageFlags(vk::ShaderStageFlagBits::eFragment);
     return binding;
 }
 
+vk::PushConstantRange PushConstantObject::getRange() {
+    vk::PushConstantRange range;
+    range
+    .setOffset(0)
+    .setSize(sizeof(PushConstantObject))
+    .setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+    return range;
+}
+
 }
@@ -9,12 +9,33 @@
 
 #include "vulkan/vulkan.hpp"
 
+#include <array>
+#include <string_view>
+#include <cstdint>
+
 namespace toy2d {
 
 struct UniformObject {
     float opacity;
 
+    // uniform blocks of this type name are fed from the per-frame ring with dynamic offsets
+    static constexpr std::string_view blockName = "UniformObject";
+
     static vk::DescriptorSetLayoutBinding getBinding();
 };
 
+// per-draw data recorded straight into the command buffer, layout matches the std430 push_constant block in shaders
+struct PushConstantObject {
+    std::array<float, 4> transform = {1.0f, 0.0f, 0.0f, 1.0f}; // column-major mat2
+    std::array<float, 2> offset = {0.0f, 0.0f};
+    float opacity = 1.0f;
+    uint32_t textureIndex = 0; // reserved for texture arrays, texture.frag samples a single texture
+    std::array<float, 4> tint = {1.0f, 1.0f, 1.0f, 1.0f};
+    vk::DeviceAddress scene = 0; // buffer_reference for programs reading scene data through GPU pointers
+
+    static vk::PushConstantRange getRange();
+};
+
+static_assert(sizeof(PushConstantObject) <= 128, "push constants are only guaranteed up to 128 bytes");
+
 }
@@ -0,0 +1,66 @@
+/**
+  * @file   uniform_ring.cpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#include "uniform_ring.hpp"
+
+#include "context.hpp"
+
+namespace toy2d {
+
+UniformRing::UniformRing(vk::DeviceSize regionSize, int frameCount) {
+    auto& ctx = Context::GetInstance();
+    _alignment = ctx.phyDevice.getProperties().limits.minUniformBufferOffsetAlignment;
+
+    // every region must start at an aligned offset as well
+    _regionSize = (regionSize + _alignment - 1) / _alignment * _alignment;
+
+    _buffer.reset(new Buffer(
+        _regionSize * frameCount,
+        vk::BufferUsageFlagBits::eUniformBuffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+    ));
+    _mapped = ctx.device.mapMemory(_buffer->memory, 0, _buffer->size); // mapped for the whole lifetime
+}
+
+UniformRing::~UniformRing() {
+    Context::GetInstance().device.unmapMemory(_buffer->memory);
+    _buffer.reset();
+}
+
+void UniformRing::BeginFrame(int frame) {
+    // the fence of this frame has been waited, the GPU is done with its region
+    _frame = frame;
+    _cursor = 0;
+}
+
+UniformRing::Slice UniformRing::Allocate(vk::DeviceSize size) {
+    auto aligned = (size + _alignment - 1) / _alignment * _alignment;
+    if (_cursor + aligned > _regionSize) {
+        throw std::runtime_error("Uniform ring buffer is exhausted for this frame.");
+    }
+
+    Slice slice {
+        .offset = static_cast<uint32_t>(_cursor),
+        .mapped = static_cast<char*>(_mapped) + getRegionOffset(_frame) + _cursor
+    };
+    _cursor += aligned;
+    return slice;
+}
+
+vk::Buffer UniformRing::getBuffer() const {
+    return _buffer->buffer;
+}
+
+vk::DeviceSize UniformRing::getRegionOffset(int frame) const {
+    return _regionSize * frame;
+}
+
+vk::DeviceSize UniformRing::getRegionSize() const {
+    return _regionSize;
+}
+
+}
@@ -0,0 +1,56 @@
+/**
+  * @file   uniform_ring.hpp
+  * @author 0And1Story
+  * @date   2026-10-19
+  * @brief  
+  */
+
+#pragma once
+
+#include "vulkan/vulkan.hpp"
+
+#include "buffer.hpp"
+
+#include <memory>
+#include <cstring>
+#include <cstdint>
+
+namespace toy2d {
+
+// one persistently mapped buffer split into a region per frame in flight,
+// draws take aligned slices of the current region and bind them with dynamic offsets
+class UniformRing {
+public:
+    struct Slice {
+        uint32_t offset; // dynamic offset, relative to the start of the frame region
+        void* mapped;
+    };
+
+private:
+    std::unique_ptr<Buffer> _buffer;
+    void* _mapped = nullptr;
+    vk::DeviceSize _regionSize;
+    vk::DeviceSize _alignment;
+    vk::DeviceSize _cursor = 0;
+    int _frame = 0;
+
+public:
+    UniformRing(vk::DeviceSize regionSize, int frameCount);
+    ~UniformRing();
+
+    void BeginFrame(int frame);
+    Slice Allocate(vk::DeviceSize size);
+
+    template <typename T>
+    uint32_t Push(const T& data) {
+        auto slice = Allocate(sizeof(T));
+        std::memcpy(slice.mapped, &data, sizeof(T));
+        return slice.offset;
+    }
+
+    vk::Buffer getBuffer() const;
+    vk::DeviceSize getRegionOffset(int frame) const;
+    vk::DeviceSize getRegionSize() const;
+};
+
+}
@@ -7,28 +7,12 @@
 
 #include "utility.hpp"
 
-namespace toy2d {
-
-std::string ReadWholeFile(const std::string& filepath, std::ios::openmode mode) {
-    std::ifstream file(filepath, mode | std::ios::ate);
-
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << filepath << std::endl;
-        return {};
-    }
-
-    auto size = file.tellg();
-    std::string content;
-    content.resize(size);
-    file.seekg(0);
+#include "mapped_file.hpp"
 
-    file.read(content.data(), size);
-
-    return content;
-}
+namespace toy2d {
 
-std::string ReadShaderFile(const std::string& filepath) {
-    return ReadWholeFile(filepath, std::ios::binary);
+std::string ReadWholeFile(const std::string& filepath) {
+    return std::string(MappedFile(filepath).view());
 }
 
 }
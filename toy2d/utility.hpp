@@ -17,7 +17,12 @@ namespace toy2d {
 
 using CreateSurfaceFunc = std::function<vk::SurfaceKHR(vk::Instance)>;
 
-std::string ReadWholeFile(const std::string& filepath, std::ios::openmode mode = std::ios::ate);
-std::string ReadShaderFile(const std::string& filepath);
+template <typename T>
+void HashCombine(size_t& seed, const T& value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// copies the file, prefer MappedFile when the contents only need to be read
+std::string ReadWholeFile(const std::string& filepath);
 
 }
@@ -1,31 +1,28 @@
 /**
   * @file   vertex.cpp
   * @author 0And1Story
-  * @date   2026-01-16
+  * @date   2026-10-19
   * @brief  
   */
 
 #include "vertex.hpp"
 
-namespace toy2d {
+#include "context.hpp"
 
-vk::VertexInputAttributeDescription vec2::getAttribute() {
-    vk::VertexInputAttributeDescription attr;
-    attr
-    .setBinding(0)
-    .setFormat(vk::Format::eR32G32Sfloat)
-    .setLocation(0)
-    .setOffset(0);
-    return attr;
-}
+#include <stdexcept>
+
+namespace toy2d {
 
-vk::VertexInputBindingDescription vec2::getBinding() {
-    vk::VertexInputBindingDescription binding;
-    binding
-    .setBinding(0)
-    .setInputRate(vk::VertexInputRate::eVertex) // per-vertex data
-    .setStride(sizeof(vec2));
-    return binding;
+void CheckVertexFormats(std::span<const vk::VertexInputAttributeDescription> attributes) {
+    auto& phyDevice = Context::GetInstance().phyDevice;
+    for (const auto& attribute : attributes) {
+        // only a few packed formats are guaranteed, the rest depend on the device
+        auto features = phyDevice.getFormatProperties(attribute.format).bufferFeatures;
+        if (!(features & vk::FormatFeatureFlagBits::eVertexBuffer)) {
+            throw std::runtime_error("Vertex format " + vk::to_string(attribute.format) + " of location " +
+                                     std::to_string(attribute.location) + " is not supported by the device.");
+        }
+    }
 }
 
 }
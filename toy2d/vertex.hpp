@@ -9,13 +9,248 @@
 
 #include "vulkan/vulkan.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
 namespace toy2d {
 
 struct vec2 {
     float x, y;
+};
+
+struct vec3 {
+    float x, y, z;
+};
+
+struct vec4 {
+    float x, y, z, w;
+};
+
+// packed attribute types, the GPU expands them to floats when fetching
+
+// IEEE binary16, round to nearest even
+struct half {
+    uint16_t bits;
+
+    static constexpr half FromFloat(float value) {
+        auto f = std::bit_cast<uint32_t>(value);
+        uint32_t sign = (f >> 16) & 0x8000;
+        int32_t exponent = static_cast<int32_t>((f >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = f & 0x7fffff;
+
+        if (((f >> 23) & 0xff) == 0xff) { // inf and nan
+            return { static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0)) };
+        }
+        if (exponent >= 31) return { static_cast<uint16_t>(sign | 0x7c00) };
+        if (exponent <= 0) { // subnormal or zero
+            if (exponent < -10) return { static_cast<uint16_t>(sign) };
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - exponent);
+            uint32_t result = mantissa >> shift;
+            uint32_t rest = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (rest > halfway || (rest == halfway && (result & 1))) ++result;
+            return { static_cast<uint16_t>(sign | result) };
+        }
+        uint32_t result = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        uint32_t rest = mantissa & 0x1fff;
+        if (rest > 0x1000 || (rest == 0x1000 && (result & 1))) ++result; // may carry into the exponent, which is correct
+        return { static_cast<uint16_t>(result) };
+    }
+};
+
+struct half2 {
+    half x, y;
+
+    static constexpr half2 FromFloat(float x, float y) { return { half::FromFloat(x), half::FromFloat(y) }; }
+};
+
+// [-1, 1] in 16 bits per component
+struct snorm16x2 {
+    int16_t x, y;
 
-    static vk::VertexInputAttributeDescription getAttribute();
-    static vk::VertexInputBindingDescription getBinding();
+    static constexpr int16_t Encode(float value) {
+        value = std::clamp(value, -1.0f, 1.0f) * 32767.0f;
+        return static_cast<int16_t>(value < 0 ? value - 0.5f : value + 0.5f);
+    }
+    static constexpr snorm16x2 FromFloat(float x, float y) { return { Encode(x), Encode(y) }; }
 };
 
+// [0, 1] in 16 bits per component, e.g. texture coordinates inside an atlas
+struct unorm16x2 {
+    uint16_t x, y;
+
+    static constexpr uint16_t Encode(float value) {
+        return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+    }
+    static constexpr unorm16x2 FromFloat(float x, float y) { return { Encode(x), Encode(y) }; }
+};
+
+// [0, 1] in 8 bits per component, e.g. vertex colors
+struct unorm8x4 {
+    uint8_t r, g, b, a;
+
+    static constexpr uint8_t Encode(float value) {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+    static constexpr unorm8x4 FromFloat(float r, float g, float b, float a = 1.0f) {
+        return { Encode(r), Encode(g), Encode(b), Encode(a) };
+    }
+};
+
+// normals in 10:10:10:2, biased to [0, 1] since only the UNORM layout is a guaranteed vertex format,
+// decode with n * 2.0 - 1.0 in the shader; w is left at zero
+struct normal10 {
+    uint32_t bits;
+
+    static constexpr uint32_t Encode(float value) {
+        return static_cast<uint32_t>((std::clamp(value, -1.0f, 1.0f) * 0.5f + 0.5f) * 1023.0f + 0.5f);
+    }
+    static constexpr normal10 FromFloat(float x, float y, float z) {
+        return { Encode(x) | (Encode(y) << 10) | (Encode(z) << 20) };
+    }
+};
+
+// the format each attribute type is fetched with, add a specialization for new types
+template <typename T> struct VertexFormatOf;
+template <> struct VertexFormatOf<float>     { static constexpr vk::Format format = vk::Format::eR32Sfloat; };
+template <> struct VertexFormatOf<vec2>      { static constexpr vk::Format format = vk::Format::eR32G32Sfloat; };
+template <> struct VertexFormatOf<vec3>      { static constexpr vk::Format format = vk::Format::eR32G32B32Sfloat; };
+template <> struct VertexFormatOf<vec4>      { static constexpr vk::Format format = vk::Format::eR32G32B32A32Sfloat; };
+template <> struct VertexFormatOf<half2>     { static constexpr vk::Format format = vk::Format::eR16G16Sfloat; };
+template <> struct VertexFormatOf<snorm16x2> { static constexpr vk::Format format = vk::Format::eR16G16Snorm; };
+template <> struct VertexFormatOf<unorm16x2> { static constexpr vk::Format format = vk::Format::eR16G16Unorm; };
+template <> struct VertexFormatOf<unorm8x4>  { static constexpr vk::Format format = vk::Format::eR8G8B8A8Unorm; };
+template <> struct VertexFormatOf<normal10>  { static constexpr vk::Format format = vk::Format::eA2B10G10R10UnormPack32; };
+
+struct VertexAttribute {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t alignment; // of one component, Vulkan wants attribute offsets aligned to it
+    vk::Format format;
+};
+
+// one attribute per member, in location order:
+//   template <> struct VertexTraits<SpriteVertex> {
+//       static constexpr std::array attributes = {
+//           TOY2D_VERTEX_ATTRIBUTE(SpriteVertex, position),
+//           TOY2D_VERTEX_ATTRIBUTE(SpriteVertex, uv),
+//       };
+//   };
+template <typename V> struct VertexTraits;
+
+#define TOY2D_VERTEX_ATTRIBUTE(Vertex, member)                                          \
+    ::toy2d::VertexAttribute {                                                          \
+        static_cast<uint32_t>(offsetof(Vertex, member)),                                \
+        static_cast<uint32_t>(sizeof(Vertex::member)),                                  \
+        static_cast<uint32_t>(alignof(decltype(Vertex::member))),                       \
+        ::toy2d::VertexFormatOf<std::remove_cv_t<decltype(Vertex::member)>>::format     \
+    }
+
+template <typename V>
+concept VertexType = std::is_standard_layout_v<V> && requires { VertexTraits<V>::attributes; };
+
+template <VertexType V>
+constexpr bool IsValidVertexLayout() {
+    const auto& attributes = VertexTraits<V>::attributes;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        const auto& attribute = attributes[i];
+        if (attribute.offset % attribute.alignment != 0 || attribute.offset + attribute.size > sizeof(V)) return false;
+        for (size_t j = 0; j < i; ++j) {
+            const auto& other = attributes[j];
+            if (attribute.offset < other.offset + other.size && other.offset < attribute.offset + attribute.size) return false;
+        }
+    }
+    return true;
+}
+
+template <VertexType V, uint32_t Binding = 0, uint32_t FirstLocation = 0>
+constexpr auto VertexAttributeDescriptions() {
+    static_assert(IsValidVertexLayout<V>(), "vertex attributes overlap, are misaligned or lie outside the vertex");
+    constexpr const auto& attributes = VertexTraits<V>::attributes;
+    std::array<vk::VertexInputAttributeDescription, attributes.size()> descriptions;
+    for (uint32_t i = 0; i < attributes.size(); ++i) {
+        descriptions[i] = vk::VertexInputAttributeDescription(FirstLocation + i, Binding, attributes[i].format, attributes[i].offset);
+    }
+    return descriptions;
+}
+
+template <VertexType V, uint32_t Binding = 0>
+constexpr vk::VertexInputBindingDescription VertexBindingDescription(vk::VertexInputRate inputRate = vk::VertexInputRate::eVertex) {
+    return vk::VertexInputBindingDescription(Binding, sizeof(V), inputRate);
+}
+
+// what PipelineDesc takes, a single interleaved binding
+struct VertexLayout {
+    std::vector<vk::VertexInputBindingDescription> bindings;
+    std::vector<vk::VertexInputAttributeDescription> attributes;
+
+    bool operator==(const VertexLayout& other) const = default;
+};
+
+// throws if the device cannot fetch one of the attribute formats from a vertex buffer
+void CheckVertexFormats(std::span<const vk::VertexInputAttributeDescription> attributes);
+
+template <VertexType V>
+VertexLayout MakeVertexLayout() {
+    static constexpr auto attributes = VertexAttributeDescriptions<V>();
+    CheckVertexFormats(attributes);
+    return { { VertexBindingDescription<V>() }, { attributes.begin(), attributes.end() } };
+}
+
+template <> struct VertexTraits<vec2> {
+    static constexpr std::array attributes = {
+        VertexAttribute { 0, sizeof(vec2), alignof(float), VertexFormatOf<vec2>::format },
+    };
+};
+
+// a textured quad corner, 12 bytes instead of 16
+struct TexturedVertex {
+    vec2 position;
+    half2 uv;
+};
+
+template <> struct VertexTraits<TexturedVertex> {
+    static constexpr std::array attributes = {
+        TOY2D_VERTEX_ATTRIBUTE(TexturedVertex, position),
+        TOY2D_VERTEX_ATTRIBUTE(TexturedVertex, uv),
+    };
+};
+
+// a flat colored vertex, 12 bytes instead of 24
+struct ColoredVertex {
+    vec2 position;
+    unorm8x4 color;
+};
+
+template <> struct VertexTraits<ColoredVertex> {
+    static constexpr std::array attributes = {
+        TOY2D_VERTEX_ATTRIBUTE(ColoredVertex, position),
+        TOY2D_VERTEX_ATTRIBUTE(ColoredVertex, color),
+    };
+};
+
+// a sprite corner in 12 bytes instead of 32, position is relative to the batch, see QuantizationFrame
+struct SpriteVertex {
+    snorm16x2 position;
+    unorm16x2 uv;
+    unorm8x4 color;
+};
+
+template <> struct VertexTraits<SpriteVertex> {
+    static constexpr std::array attributes = {
+        TOY2D_VERTEX_ATTRIBUTE(SpriteVertex, position),
+        TOY2D_VERTEX_ATTRIBUTE(SpriteVertex, uv),
+        TOY2D_VERTEX_ATTRIBUTE(SpriteVertex, color),
+    };
+};
+
+static_assert(sizeof(SpriteVertex) == 12);
+
 }